@@ -15,9 +15,12 @@
  * along with the rubik.  If not, see <https://www.gnu.org/licenses/>.
  */
 
-#include <stdio.h> /* NULL, EOF, stderr, printf, fprintf, getchar */
-#include <string.h> /* strchr, strcmp */
-#include <ctype.h> /* isgraph */
+#include <stdio.h> /* NULL, EOF, FILE, stderr, printf, fprintf, getchar */
+#include <string.h> /* strchr, strcmp, strlen, memcmp, memcpy, memset */
+#include <stdlib.h> /* strtoul, atoi, malloc, realloc, free, (s)rand, calloc */
+#include <ctype.h> /* isgraph, isdigit */
+#include <limits.h> /* UCHAR_MAX, CHAR_BIT, LONG_MAX */
+#include <time.h> /* clock_t, clock, CLOCKS_PER_SEC */
 
 #define NFACES 6
 #define EMPTY_COLOR (-1)
@@ -27,9 +30,30 @@
 #define NVALUES_CUBE 48
 #define NMINICUBES_PER_FACE 8
 
+#define NFACE_MASKS (1 << NFACES)
+#define NFACELETS 54
+
+/* The tables calculated by the init functions are read-only data included
+from rubik_tables.h, generated with the option --tables of a program compiled
+with INIT_TABLES defined, that calculates them when it starts:
+gcc -ansi -Wall -pedantic -DINIT_TABLES -o rubik_init rubik.c
+./rubik_init --tables > rubik_tables.h
+Without NDEBUG the tests calculate them again to check the included ones. */
+#ifdef INIT_TABLES
 char ORIGCOLORS[NMINICUBES][NFACES];
 char ORIENTATIONS[NORIENTS][NFACES];
 char TRANSFORMATIONS[NROTATIONS][NORIENTS];
+char POSITIONS_BY_MASK[NFACE_MASKS];
+char ORIENTS_BY_FACES[NFACES][NFACES];
+char POSITIONS_BY_ORIENT[NMINICUBES][NORIENTS];
+char FACELET_POSITIONS[NFACELETS];
+char FACELET_FACES[NFACELETS];
+char POSITION_FACELETS[NMINICUBES][NFACES];
+char FACELET_ORIENTS[NMINICUBES][NFACES][NFACES];
+char STICKER_INDEXES[NMINICUBES][NFACES];
+#else
+#include "rubik_tables.h"
+#endif
 
 /* Faces of the cube and each minicube, used also as the colors of the faces:
        |z
@@ -49,7 +73,7 @@ char TRANSFORMATIONS[NROTATIONS][NORIENTS];
  * Also, shows the successive positions of the faces when rotating a minicube,
  * for example, rotating the minicube from the face in 0, face in 1 moves to 2,
  * face in 2 moves to 4, face in 4 moves to 3 and face in 3 moves to 1. */
-char ADJACENTS[NFACES][4] = {
+const char ADJACENTS[NFACES][4] = {
 	{1, 2, 4, 3},
 	{0, 3, 5, 2},
 	{0, 1, 5, 4},
@@ -57,10 +81,10 @@ char ADJACENTS[NFACES][4] = {
 	{0, 2, 5, 3},
 	{1, 3, 4, 2}
 };
-char OPPOSITES[NFACES] = {5, 4, 3, 2, 1, 0};
+const char OPPOSITES[NFACES] = {5, 4, 3, 2, 1, 0};
 
 /** Ordered indexes of the non-empty faces of each minicube in x,y,z order. */
-char CUBE_FACES_INDEXES[NVALUES_CUBE][2] = {
+const char CUBE_FACES_INDEXES[NVALUES_CUBE][2] = {
 	{0, 2}, {0, 4}, {0, 5},
 	{1, 4}, {1, 5},
 	{2, 3}, {2, 4}, {2, 5},
@@ -101,7 +125,7 @@ char CUBE_FACES_INDEXES[NVALUES_CUBE][2] = {
 
 /** Positions of the minicubes of each face, corners first and edges second,
  * in clockwise order each group, minor value first. */
-char POSITIONS_BY_FACE[NFACES][NMINICUBES_PER_FACE] = {
+const char POSITIONS_BY_FACE[NFACES][NMINICUBES_PER_FACE] = {
 	{12, 14, 19, 17,   13, 16, 18, 15},
 	{ 5, 17, 19,  7,    6, 10, 18, 11},
 	{ 0, 12, 17,  5,    3,  8, 15, 10},
@@ -150,7 +174,7 @@ int count_minicube_colors(int x, int y, int z) {
 
 /** Colors of the faces of all external minicubes except the central ones,
  * in x,y,z order (modifying first the x, then the y and then the z). */
-void init_original_minicube_colors() {
+void init_original_minicube_colors(char origcolors[NMINICUBES][NFACES]) {
 	int i, x, y, z, f;
 	char *mc;
 	i = 0;
@@ -158,7 +182,7 @@ void init_original_minicube_colors() {
 		for (y = 0; y < 3; y++) {
 			for (x = 0; x < 3; x++) {
 				if (count_minicube_colors(x, y, z) > 1) {
-					mc = ORIGCOLORS[i];
+					mc = origcolors[i];
 					for (f = 0; f < NFACES; f++) {
 						mc[f] = init_color(f, x, y, z);
 					}
@@ -169,31 +193,36 @@ void init_original_minicube_colors() {
 	}
 }
 
-/** Given the current colors of the faces of a minicube returns its position
- * (currently searches the minicube colors in the initial state of the cube).
- * This function allows to calculate the positions using the orientations. */
-int find_minicube_position(char minicubecolors[NFACES]) {
-	int i, f, found;
-	char *origminicubecolors;
-	for (i = 0; i < NMINICUBES; i++) {
-		origminicubecolors = ORIGCOLORS[i];
-		found = 1;
-		for (f = 0; f < NFACES; f++) {
-			if (origminicubecolors[f] == EMPTY_COLOR) {
-				if (minicubecolors[f] != EMPTY_COLOR) {
-					found = 0;
-					break;
-				}
-			} else if (minicubecolors[f] == EMPTY_COLOR) {
-				found = 0;
-				break;
-			}
-		}
-		if (found) {
-			return i;
+/** Bits of the faces of a minicube that are coloured, 1 for face 0 and so on,
+ * that are different for each position of the cube. */
+int minicube_face_mask(const char minicubecolors[NFACES]) {
+	int f, mask = 0;
+	for (f = 0; f < NFACES; f++) {
+		if (minicubecolors[f] != EMPTY_COLOR) {
+			mask |= 1 << f;
 		}
 	}
-	return -1;
+	return mask;
+}
+
+/** Position of the minicube with each mask of coloured faces, or -1 if none.
+ * Requires ORIGCOLORS[NMINICUBES][NFACES]. */
+void init_positions_by_mask(char positionsbymask[NFACE_MASKS]) {
+	int i;
+	for (i = 0; i < NFACE_MASKS; i++) {
+		positionsbymask[i] = -1;
+	}
+	for (i = 0; i < NMINICUBES; i++) {
+		positionsbymask[minicube_face_mask(ORIGCOLORS[i])] = i;
+	}
+}
+
+/** Given the current colors of the faces of a minicube returns its position
+ * (the position in the initial state of the cube with the same faces coloured).
+ * This function allows to calculate the positions using the orientations.
+ * Requires POSITIONS_BY_MASK[NFACE_MASKS]. */
+int find_minicube_position(const char minicubecolors[NFACES]) {
+	return POSITIONS_BY_MASK[minicube_face_mask(minicubecolors)];
 }
 
 void print_original_cube_colors() {
@@ -214,14 +243,15 @@ void print_original_cube_colors() {
 }
 
 /** Each orientation of a minicube is defined by a new distribution of faces. */
-void init_minicube_orientations() {
+void init_minicube_orientations(char orientations[NORIENTS][NFACES]) {
 	int i, f, a;
-	char *orient, *adjacents;
+	char *orient;
+	const char *adjacents;
 	i = 0;
 	for (f = 0; f < NFACES; f++) {
 		adjacents = ADJACENTS[f];
 		for (a = 0; a < 4; a++) {
-			orient = ORIENTATIONS[i++];
+			orient = orientations[i++];
 			orient[0] = f;
 			orient[1] = adjacents[a];
 			orient[2] = adjacents[(a + 1) % 4];
@@ -234,11 +264,12 @@ void init_minicube_orientations() {
 
 #define LINE_BUFFER_SIZE 100L
 /** Prints the lines replacing the one-char keys found with the given values. */
-void print_template(char *linesarr, size_t nrows, size_t ncols,
+void print_template(const char *linesarr, size_t nrows, size_t ncols,
 		char *keys, char *values, char *indent) {
 	int i, j, k;
 	size_t maxlen;
-	char *line, ch, key, value, tmpline[LINE_BUFFER_SIZE];
+	const char *line;
+	char ch, key, value, tmpline[LINE_BUFFER_SIZE];
 	maxlen = (ncols > LINE_BUFFER_SIZE ? LINE_BUFFER_SIZE : ncols) - 1L;
 	for (i = 0; i < nrows; i++) {
 		line = linesarr + (i * ncols);
@@ -258,7 +289,7 @@ void print_template(char *linesarr, size_t nrows, size_t ncols,
 
 #define NROWS_ORIENT_TPL 9
 #define NCOLS_ORIENT_TPL 14
-char LINES_ORIENT_TPL[NROWS_ORIENT_TPL][NCOLS_ORIENT_TPL] = {
+const char LINES_ORIENT_TPL[NROWS_ORIENT_TPL][NCOLS_ORIENT_TPL] = {
 	   " ____E___",
 	"   /.      /|",
 	"  / . A   / |",
@@ -270,13 +301,13 @@ char LINES_ORIENT_TPL[NROWS_ORIENT_TPL][NCOLS_ORIENT_TPL] = {
 	"      F"
 };
 
-void print_orientation_3d(char *orient) {
+void print_orientation_3d(const char *orient) {
 	int f;
 	char values[NFACES];
 	for (f = 0; f < NFACES; f++) {
 		values[f] = color_to_char(orient[f]);
 	}
-	print_template((char *) LINES_ORIENT_TPL,
+	print_template((const char *) LINES_ORIENT_TPL,
 		NROWS_ORIENT_TPL, NCOLS_ORIENT_TPL, "ABCDEF", values, "   ");
 }
 
@@ -294,7 +325,8 @@ void print_orientations_3d() {
 
 /** Rotates a minicube clockwise from the given face. */
 void rotate_minicube(char face, char colors[NFACES]) {
-	char *adjacents = ADJACENTS[(int) face], aux;
+	const char *adjacents = ADJACENTS[(int) face];
+	char aux;
 	aux = colors[(int) adjacents[0]];
 	colors[(int) adjacents[0]] = colors[(int) adjacents[3]];
 	colors[(int) adjacents[3]] = colors[(int) adjacents[2]];
@@ -302,43 +334,54 @@ void rotate_minicube(char face, char colors[NFACES]) {
 	colors[(int) adjacents[1]] = aux;
 }
 
-void copy_orientation(char dest[NFACES], char orig[NFACES]) {
+void copy_orientation(char dest[NFACES], const char orig[NFACES]) {
 	int f;
 	for (f = 0; f < NFACES; f++) {
 		dest[f] = orig[f];
 	}
 }
 
-/* Finds in the global table the index of an orientation given by its colors.
+/** Each orientation is identified by the faces moved to the faces 0 and 1,
+ * the table has -1 for the pairs of faces that are the same or opposite.
  * Requires ORIENTATIONS[NORIENTS][NFACES]. */
-char find_orientation(char searchedcolors[NFACES]) {
-	int i, f;
-	char *colors, found;
-	for (i = 0; i < NORIENTS; i++) {
-		colors = ORIENTATIONS[i];
-		found = 1;
-		for (f = 0; f < NFACES; f++) {
-			if (colors[f] != searchedcolors[f]) {
-				found = 0;
-				break;
-			}
-		}
-		if (found) {
-			return i;
+void init_orientations_by_faces(char orientsbyfaces[NFACES][NFACES]) {
+	int i, j;
+	for (i = 0; i < NFACES; i++) {
+		for (j = 0; j < NFACES; j++) {
+			orientsbyfaces[i][j] = -1;
 		}
 	}
-	return -1;
+	for (i = 0; i < NORIENTS; i++) {
+		orientsbyfaces[(int) ORIENTATIONS[i][0]]
+				[(int) ORIENTATIONS[i][1]] = i;
+	}
+}
+
+/* Finds in the global table the index of an orientation given by its colors.
+ * Requires ORIENTATIONS[NORIENTS][NFACES], ORIENTS_BY_FACES[NFACES][NFACES]. */
+char find_orientation(char searchedcolors[NFACES]) {
+	char i;
+	if (searchedcolors[0] < 0 || searchedcolors[0] >= NFACES
+	|| searchedcolors[1] < 0 || searchedcolors[1] >= NFACES) {
+		return -1;
+	}
+	i = ORIENTS_BY_FACES[(int) searchedcolors[0]][(int) searchedcolors[1]];
+	if (i == -1 || memcmp(ORIENTATIONS[(int) i], searchedcolors, NFACES)) {
+		return -1;
+	}
+	return i;
 }
 
 /** The transformations table knows the new orientation of a minicube
  * given the rotation applied to it and its previous orientation. Note that the
  * rotations are clockwise, for counter-clockwise, rotate by its opposite face.
  * Requires ORIENTATIONS[NORIENTS][NFACES]. */
-void init_minicube_transformations() {
+void init_minicube_transformations(
+		char transformations[NROTATIONS][NORIENTS]) {
 	int r, i;
 	char *neworients, colors[NFACES];
 	for (r = 0; r < NROTATIONS; r++) {
-		neworients = TRANSFORMATIONS[r];
+		neworients = transformations[r];
 		for (i = 0; i < NORIENTS; i++) {
 			copy_orientation(colors, ORIENTATIONS[i]);
 			rotate_minicube(r, colors);
@@ -349,7 +392,7 @@ void init_minicube_transformations() {
 
 void print_transformations() {
 	int r, i;
-	char *neworients;
+	const char *neworients;
 	printf("ORIENT|");
 	for (i = 0; i < NORIENTS; i++) {
 		printf(" %2d", i);
@@ -371,27 +414,44 @@ void print_transformations() {
 
 /** Assigns the colors of the minicube in the order of the given orientation. */
 void apply_orientation(char newminicubecolors[NFACES],
-			char origminicubecolors[NFACES], char orient[NFACES]) {
+			const char origminicubecolors[NFACES],
+			const char orient[NFACES]) {
 	int f;
 	for (f = 0; f < NFACES; f++) {
 		newminicubecolors[f] = origminicubecolors[(int) orient[f]];
 	}
 }
 
+/** The position where each minicube is moved by each orientation.
+ * Requires ORIGCOLORS[NMINICUBES][NFACES], ORIENTATIONS[NORIENTS][NFACES],
+ * POSITIONS_BY_MASK[NFACE_MASKS]. */
+void init_positions_by_orientation(
+		char positionsbyorient[NMINICUBES][NORIENTS]) {
+	int i, o;
+	char minicubecolors[NFACES];
+	for (i = 0; i < NMINICUBES; i++) {
+		for (o = 0; o < NORIENTS; o++) {
+			apply_orientation(minicubecolors, ORIGCOLORS[i],
+					ORIENTATIONS[o]);
+			positionsbyorient[i][o] =
+				find_minicube_position(minicubecolors);
+		}
+	}
+}
+
 /** Saves the initial orientations and positions of the minicubes of the cube,
-returning false if the given cube point has minicubes in the same position. */
+returning false if the given cube point has minicubes in the same position.
+Requires POSITIONS_BY_ORIENT[NMINICUBES][NORIENTS]. */
 char init_cube_point(char currentorients[NMINICUBES],
 			char minicubesbypos[NMINICUBES], char *initialpoint) {
 	int i;
-	char minicubecolors[NFACES], pos;
+	char pos;
 	for (i = 0; i < NMINICUBES; i++) {
 		currentorients[i] = initialpoint[i] - 'A';
 		minicubesbypos[i] = -1;
 	}
 	for (i = 0; i < NMINICUBES; i++) {
-		apply_orientation(minicubecolors, ORIGCOLORS[i],
-				ORIENTATIONS[(int) currentorients[i]]);
-		pos = find_minicube_position(minicubecolors);
+		pos = POSITIONS_BY_ORIENT[i][(int) currentorients[i]];
 		if (minicubesbypos[(int) pos] != -1) {
 			return 0;
 		}
@@ -401,10 +461,10 @@ char init_cube_point(char currentorients[NMINICUBES],
 }
 
 void print_cube_3d_template(char cubecolors[NMINICUBES][NFACES],
-		char *lines, size_t nrows, size_t ncols, char *keys) {
+		const char *lines, size_t nrows, size_t ncols, char *keys) {
 	int i, f;
-	char *idx;
-	char values[NVALUES_CUBE + 2];
+	const char *idx;
+	char values[NVALUES_CUBE + 1 + NFACES + 1];
 	for (i = 0; i < NVALUES_CUBE; i++) {
 		idx = CUBE_FACES_INDEXES[i];
 		values[i] =
@@ -420,7 +480,7 @@ void print_cube_3d_template(char cubecolors[NMINICUBES][NFACES],
 
 #define NROWS_CUBE_TPL 17
 #define NCOLS_CUBE_TPL 63
-char LINES_CUBE_TPL[NROWS_CUBE_TPL][NCOLS_CUBE_TPL] = {
+const char LINES_CUBE_TPL[NROWS_CUBE_TPL][NCOLS_CUBE_TPL] = {
 	"         ___p_____q_____r__ (n      __C_____B_____A__ (E",
 	"       Y/  A  /  B  /  C  /|       |     |     |     |",
 	"       /_____/_____/_____/ |r     g|  r  |  q  |  p  |*A",
@@ -454,7 +514,7 @@ void print_cube_3d(char currentorients[NMINICUBES],
 		apply_orientation(newcubecolors[i], ORIGCOLORS[mcidx],
 				ORIENTATIONS[(int) currentorients[mcidx]]);
 	}
-	print_cube_3d_template(newcubecolors, (char *) LINES_CUBE_TPL,
+	print_cube_3d_template(newcubecolors, (const char *) LINES_CUBE_TPL,
 			NROWS_CUBE_TPL, NCOLS_CUBE_TPL, KEYS_CUBE_TPL);
 	printf("\n");
 }
@@ -471,7 +531,7 @@ void print_positions_by_face() {
 	}
 }
 
-void move_minicubes(char mcbypos[NMINICUBES], char posarr[4]) {
+void move_minicubes(char mcbypos[NMINICUBES], const char posarr[4]) {
 	int tmp = mcbypos[(int) posarr[3]];
 	mcbypos[(int) posarr[3]] = mcbypos[(int) posarr[2]];
 	mcbypos[(int) posarr[2]] = mcbypos[(int) posarr[1]];
@@ -479,7 +539,8 @@ void move_minicubes(char mcbypos[NMINICUBES], char posarr[4]) {
 	mcbypos[(int) posarr[0]] = tmp;
 }
 
-void move_minicubes_reverse(char mcbypos[NMINICUBES], char posarr[4]) {
+void move_minicubes_reverse(char mcbypos[NMINICUBES],
+		const char posarr[4]) {
 	int tmp = mcbypos[(int) posarr[0]];
 	mcbypos[(int) posarr[0]] = mcbypos[(int) posarr[1]];
 	mcbypos[(int) posarr[1]] = mcbypos[(int) posarr[2]];
@@ -504,7 +565,7 @@ int reduce_times(int times) {
 void rotate_cube_face(char face, int times, char currentorients[NMINICUBES],
 		char minicubesbypos[NMINICUBES]) {
 	int t, n, p, i;
-	char *posarr, *transform;
+	const char *posarr, *transform;
 	if (! times) {
 		return;
 	}
@@ -533,13 +594,19 @@ void rotate_cube_face(char face, int times, char currentorients[NMINICUBES],
 	}
 }
 
-void print_cube_point(char currentorients[NMINICUBES]) {
+/** Letters A-X of the orientations of the minicubes, ended with '\0'. */
+void cube_point_chars(char currentorients[NMINICUBES],
+		char chars[NMINICUBES + 1]) {
 	int i;
-	char chars[NMINICUBES + 1];
 	for (i = 0; i < NMINICUBES; i++) {
 		chars[i] = currentorients[i] + 'A';
 	}
 	chars[i] = '\0';
+}
+
+void print_cube_point(char currentorients[NMINICUBES]) {
+	char chars[NMINICUBES + 1];
+	cube_point_chars(currentorients, chars);
 	printf("        %s\n", chars);
 }
 
@@ -558,6 +625,648 @@ int valid_cube_point_chars(char *arg) {
 	return 1;
 }
 
+/** Statistics of the solved minicubes of a cube, updated with each rotation
+ * of a face checking only the 8 minicubes of that face. */
+struct rubik_cube_stats_st {
+	int nsolved; /* minicubes in their position and orientation */
+	int nplaced; /* minicubes in their position with any orientation */
+	int facesolved[NFACES]; /* solved minicubes of the positions of each face */
+	int nsolvedfaces; /* faces with their 8 minicubes solved */
+};
+
+/** Adds (sign 1) or subtracts (sign -1) to the statistics the minicube that
+ * is in the given position, which is solved when it is the minicube of that
+ * position with the original orientation A.
+ * Requires ORIGCOLORS[NMINICUBES][NFACES]. */
+void count_position_stats(struct rubik_cube_stats_st *stats, int pos, int sign,
+		char currentorients[NMINICUBES], char minicubesbypos[NMINICUBES]) {
+	int f;
+	if (minicubesbypos[pos] != pos) {
+		return;
+	}
+	stats->nplaced += sign;
+	if (currentorients[pos] != 0) {
+		return;
+	}
+	stats->nsolved += sign;
+	for (f = 0; f < NFACES; f++) {
+		if (ORIGCOLORS[pos][f] != EMPTY_COLOR) {
+			if (stats->facesolved[f] == NMINICUBES_PER_FACE) {
+				stats->nsolvedfaces--;
+			}
+			stats->facesolved[f] += sign;
+			if (stats->facesolved[f] == NMINICUBES_PER_FACE) {
+				stats->nsolvedfaces++;
+			}
+		}
+	}
+}
+
+/** Counts the statistics of all the minicubes of the cube. */
+void init_cube_stats(struct rubik_cube_stats_st *stats,
+		char currentorients[NMINICUBES], char minicubesbypos[NMINICUBES]) {
+	int p;
+	memset(stats, 0, sizeof(*stats));
+	for (p = 0; p < NMINICUBES; p++) {
+		count_position_stats(stats, p, 1,
+				currentorients, minicubesbypos);
+	}
+}
+
+/** Rotates a face like rotate_cube_face updating the statistics of the cube,
+ * subtracting the minicubes of the face before and adding them after. */
+void rotate_tracked_cube_face(char face, int times,
+		char currentorients[NMINICUBES], char minicubesbypos[NMINICUBES],
+		struct rubik_cube_stats_st *stats) {
+	int p;
+	const char *posarr = POSITIONS_BY_FACE[(int) face];
+	for (p = 0; p < NMINICUBES_PER_FACE; p++) {
+		count_position_stats(stats, posarr[p], -1,
+				currentorients, minicubesbypos);
+	}
+	rotate_cube_face(face, times, currentorients, minicubesbypos);
+	for (p = 0; p < NMINICUBES_PER_FACE; p++) {
+		count_position_stats(stats, posarr[p], 1,
+				currentorients, minicubesbypos);
+	}
+}
+
+/** Prints the cube point followed by the number of solved minicubes, the
+ * number of minicubes in their position and the solved minicubes of each
+ * face from 0 to 5 as one digit. */
+void print_cube_point_stats(char currentorients[NMINICUBES],
+		struct rubik_cube_stats_st *stats) {
+	int i;
+	char chars[NMINICUBES + 1], digits[NFACES + 1];
+	cube_point_chars(currentorients, chars);
+	for (i = 0; i < NFACES; i++) {
+		digits[i] = stats->facesolved[i] + '0';
+	}
+	digits[i] = '\0';
+	printf("        %s %2d %2d %s %d\n", chars, stats->nsolved,
+			stats->nplaced, digits, stats->nsolvedfaces);
+}
+
+/* The facelets strings used by other programs have the 54 stickers of the
+faces U (0), R (3), F (1), D (5), L (2) and B (4), each face seen from outside
+with the face U up (U with B up and D with F up), from left to right and from
+top to bottom, each sticker with the character of the center of its color. */
+#define NFACELETS_PER_FACE 9
+#define FACELETS_LINE_SIZE 128
+const char FACELETS_FACES_ORDER[NFACES] = {0, 3, 1, 5, 2, 4};
+char *FACELETS_COLOR_CHARS = "UFLRBD";
+
+/** Coordinates of the sticker of the given row and column of a face, in a
+ * cube where the given last is the maximum coordinate (2 for 3x3x3). */
+void init_facelet_coords(int face, int row, int col, int last,
+		int *x, int *y, int *z) {
+	switch (face) {
+		case 0: *x = col; *y = row; *z = last; break;
+		case 1: *x = col; *y = last; *z = last - row; break;
+		case 2: *x = 0; *y = col; *z = last - row; break;
+		case 3: *x = last; *y = last - col; *z = last - row; break;
+		case 4: *x = last - col; *y = 0; *z = last - row; break;
+		case 5: *x = col; *y = last - row; *z = 0; break;
+	}
+}
+
+/** Position and face of each facelet (position -1 for the centers), facelet
+ * of each face of each position and the orientation of the minicube of each
+ * position given the colors of its first two faces with stickers.
+ * Requires ORIENTATIONS[NORIENTS][NFACES]. */
+void init_facelets(char faceletpositions[NFACELETS],
+		char faceletfaces[NFACELETS],
+		char positionfacelets[NMINICUBES][NFACES],
+		char faceletorients[NMINICUBES][NFACES][NFACES]) {
+	int i, o, x, y, z, f, k, p, firstfaces[2];
+	char positions[3][3][3];
+	i = 0;
+	for (z = 0; z < 3; z++) {
+		for (y = 0; y < 3; y++) {
+			for (x = 0; x < 3; x++) {
+				positions[x][y][z] = (count_minicube_colors(
+					x, y, z) > 1 ? i++ : -1);
+			}
+		}
+	}
+	for (p = 0; p < NMINICUBES; p++) {
+		for (f = 0; f < NFACES; f++) {
+			positionfacelets[p][f] = -1;
+		}
+	}
+	for (i = 0; i < NFACELETS; i++) {
+		f = FACELETS_FACES_ORDER[i / NFACELETS_PER_FACE];
+		k = i % NFACELETS_PER_FACE;
+		init_facelet_coords(f, k / 3, k % 3, 2, &x, &y, &z);
+		faceletpositions[i] = p = positions[x][y][z];
+		faceletfaces[i] = f;
+		if (p != -1) {
+			positionfacelets[p][f] = i;
+		}
+	}
+	for (p = 0; p < NMINICUBES; p++) {
+		for (f = k = 0; k < 2; f++) {
+			if (positionfacelets[p][f] != -1) {
+				firstfaces[k++] = f;
+			}
+		}
+		for (x = 0; x < NFACES; x++) {
+			for (y = 0; y < NFACES; y++) {
+				faceletorients[p][x][y] = -1;
+			}
+		}
+		for (o = 0; o < NORIENTS; o++) {
+			faceletorients[p][(int) ORIENTATIONS[o][firstfaces[0]]]
+				[(int) ORIENTATIONS[o][firstfaces[1]]] = o;
+		}
+	}
+}
+
+/** Writes the 54 facelets of the cube point, ended with a new line.
+ * Requires FACELET_POSITIONS[NFACELETS], FACELET_FACES[NFACELETS]. */
+void cube_point_to_facelets(char currentorients[NMINICUBES],
+		char minicubesbypos[NMINICUBES], char facelets[NFACELETS + 2]) {
+	int i, mcidx;
+	char p;
+	for (i = 0; i < NFACELETS; i++) {
+		if ((p = FACELET_POSITIONS[i]) == -1) {
+			facelets[i] = FACELETS_COLOR_CHARS[(int) FACELET_FACES[i]];
+		} else {
+			mcidx = minicubesbypos[(int) p];
+			facelets[i] = FACELETS_COLOR_CHARS[(int) ORIENTATIONS
+				[(int) currentorients[mcidx]]
+				[(int) FACELET_FACES[i]]];
+		}
+	}
+	facelets[i++] = '\n';
+	facelets[i] = '\0';
+}
+
+/** Saves the orientations of the minicubes given by the 54 facelets, returning
+ * false if the centers have repeated colors or any minicube is not valid.
+ * Requires POSITIONS_BY_MASK[NFACE_MASKS], POSITION_FACELETS[NMINICUBES][NFACES],
+ * FACELET_ORIENTS[NMINICUBES][NFACES][NFACES], ORIENTATIONS[NORIENTS][NFACES].*/
+char facelets_to_cube_point(char *facelets, char currentorients[NMINICUBES]) {
+	int i, p, f, k, colorsmask;
+	char facesbychar[UCHAR_MAX + 1], colors[NFACES], found[NMINICUBES];
+	char firstcolors[2], mcidx, o;
+	memset(facesbychar, EMPTY_COLOR, sizeof(facesbychar));
+	for (i = NFACELETS_PER_FACE / 2; i < NFACELETS; i += NFACELETS_PER_FACE) {
+		k = (unsigned char) facelets[i];
+		if (facesbychar[k] != EMPTY_COLOR) {
+			return 0;
+		}
+		facesbychar[k] = FACELET_FACES[i];
+	}
+	memset(found, 0, sizeof(found));
+	for (p = 0; p < NMINICUBES; p++) {
+		colorsmask = 0;
+		for (f = k = 0; f < NFACES; f++) {
+			if ((i = POSITION_FACELETS[p][f]) == -1) {
+				colors[f] = EMPTY_COLOR;
+				continue;
+			}
+			colors[f] = facesbychar[(unsigned char) facelets[i]];
+			if (colors[f] == EMPTY_COLOR) {
+				return 0;
+			}
+			colorsmask |= 1 << colors[f];
+			if (k < 2) {
+				firstcolors[k++] = colors[f];
+			}
+		}
+		mcidx = POSITIONS_BY_MASK[colorsmask];
+		if (mcidx == -1 || found[(int) mcidx]) {
+			return 0;
+		}
+		o = FACELET_ORIENTS[p][(int) firstcolors[0]]
+				[(int) firstcolors[1]];
+		if (o == -1) {
+			return 0;
+		}
+		for (f = 0; f < NFACES; f++) {
+			if (colors[f] != EMPTY_COLOR
+			&& colors[f] != ORIENTATIONS[(int) o][f]) {
+				return 0;
+			}
+		}
+		found[(int) mcidx] = 1;
+		currentorients[(int) mcidx] = o;
+	}
+	return 1;
+}
+
+/** Reads a line of the file without its end of line, returning EOF at the end
+ * of the file, or false if the line does not fit and the rest is skipped. */
+int read_line(FILE *file, char *line, int size) {
+	int c;
+	size_t len;
+	if (fgets(line, size, file) == NULL) {
+		return EOF;
+	}
+	len = strlen(line);
+	if (len > 0 && line[len - 1] == '\n') {
+		line[--len] = '\0';
+	} else if (! feof(file)) {
+		while ((c = getc(file)) != EOF && c != '\n')
+			;
+		return 0;
+	}
+	if (len > 0 && line[len - 1] == '\r') {
+		line[--len] = '\0';
+	}
+	return 1;
+}
+
+/** Converts each line of the input from positions to facelets or from facelets
+ * to positions, printing an empty line for each invalid line in the input.
+ * Returns false if any line was not valid.
+ * Requires the tables of init_cube_point and facelets_to_cube_point. */
+char convert_facelets_lines(char tofacelets) {
+	int valid;
+	unsigned long nline;
+	size_t len;
+	char line[FACELETS_LINE_SIZE], result[NFACELETS + 2], allvalid;
+	char currentorients[NMINICUBES], minicubesbypos[NMINICUBES];
+	allvalid = 1;
+	for (nline = 1; (valid = read_line(stdin, line, sizeof(line))) != EOF;
+			nline++) {
+		if (tofacelets) {
+			valid = valid && valid_cube_point_chars(line)
+				&& init_cube_point(currentorients,
+					minicubesbypos, line);
+			if (valid) {
+				cube_point_to_facelets(currentorients,
+						minicubesbypos, result);
+			}
+		} else {
+			valid = valid && strlen(line) == NFACELETS
+				&& facelets_to_cube_point(line, currentorients);
+			for (len = 0; valid && len < NMINICUBES; len++) {
+				result[len] = currentorients[len] + 'A';
+			}
+			result[len++] = '\n';
+			result[len] = '\0';
+		}
+		if (valid) {
+			fputs(result, stdout);
+		} else {
+			putchar('\n');
+			fprintf(stderr, "Invalid %s in line %lu\n",
+				tofacelets ? "position" : "facelets", nline);
+			allvalid = 0;
+		}
+	}
+	return allvalid;
+}
+
+/* The big cubes of any size NxNxN keep only the colors of the stickers, 3 bits
+each packed in unsigned longs, the faces in the order of the facelets and each
+face in rows like the facelets, every row starting in a new number. A turn of
+the stickers of a face only changes its count of quarter turns, so any layer
+turn moves only the 4 strips of N stickers of the faces adjacent to it. Each
+strip is a row or a column of the numbers of its face, read and written with
+the steps between its stickers calculated once. */
+#define BIG_STICKER_BITS 3
+#define BIG_STICKER_MASK 7UL
+#define BIG_STICKERS_PER_NUMBER \
+	((int) (sizeof(unsigned long) * CHAR_BIT / BIG_STICKER_BITS))
+#define MAX_BIG_CUBE_SIZE 10000
+
+/** Row and column of the sticker T of the strip of an adjacent face moved by
+ * a turn of the layer D of a face: row + rowbydepth * D + rowbystep * T, and
+ * the same for the column. Each strip starts next to the previous adjacent
+ * face, so a clockwise turn moves the sticker T of each strip to the sticker
+ * T of the strip of the next adjacent face. */
+struct rubik_big_strip_st {
+	int row, rowbydepth, rowbystep, col, colbydepth, colbystep;
+};
+
+/** Sticker of a row or a column of the numbers of a face, with the step to
+ * the next sticker, in its number when it is a row or in the numbers when it
+ * is a column. */
+struct rubik_big_line_st {
+	unsigned long *number;
+	int shift, shiftstep;
+	long numberstep;
+};
+
+struct rubik_big_cube_st {
+	int size, rownumbers;
+	unsigned long *stickers;
+	char *colors; /* colors of the 4 strips moved by a turn */
+	char turns[NFACES];
+	struct rubik_big_strip_st strips[NFACES][4];
+};
+
+/** Depth of the layer with the given coordinates counted from the face. */
+int big_layer_depth(int face, int last, int x, int y, int z) {
+	switch (face) {
+		case 0: return last - z;
+		case 1: return last - y;
+		case 2: return x;
+		case 3: return last - x;
+		case 4: return y;
+	}
+	return z;
+}
+
+/** Calculates the strips of the adjacent faces from the depths of the layers
+ * of the stickers 0,0 1,0 and 0,1 of each one, because the row or the column
+ * of a strip is the depth of the turned face, and the position of a sticker
+ * in the strip is the depth of the previous adjacent face. */
+void init_big_strips(struct rubik_big_cube_st *cube) {
+	int f, i, k, x, y, z, adjacent, previous, last = cube->size - 1;
+	int depths[3], steps[3];
+	struct rubik_big_strip_st *strip;
+	for (f = 0; f < NFACES; f++) {
+		for (i = 0; i < 4; i++) {
+			adjacent = ADJACENTS[f][i];
+			previous = ADJACENTS[f][(i + 3) % 4];
+			for (k = 0; k < 3; k++) {
+				init_facelet_coords(adjacent, k == 1, k == 2,
+					last, &x, &y, &z);
+				depths[k] = big_layer_depth(f, last, x, y, z);
+				steps[k] = big_layer_depth(previous, last,
+					x, y, z);
+			}
+			strip = &cube->strips[f][i];
+			if (depths[1] != depths[0]) {
+				strip->rowbydepth = depths[1] - depths[0];
+				strip->row = -strip->rowbydepth * depths[0];
+				strip->rowbystep = strip->colbydepth = 0;
+				strip->colbystep = steps[2] - steps[0];
+				strip->col = -strip->colbystep * steps[0];
+			} else {
+				strip->colbydepth = depths[2] - depths[0];
+				strip->col = -strip->colbydepth * depths[0];
+				strip->colbystep = strip->rowbydepth = 0;
+				strip->rowbystep = steps[1] - steps[0];
+				strip->row = -strip->rowbystep * steps[0];
+			}
+		}
+	}
+}
+
+/** Returns all the stickers of the big cube to the color of their face. */
+void reset_big_cube(struct rubik_big_cube_st *cube) {
+	int f, k;
+	long i, nfacenumbers = (long) cube->size * cube->rownumbers;
+	unsigned long number;
+	for (f = 0; f < NFACES; f++) {
+		number = 0;
+		for (k = 0; k < BIG_STICKERS_PER_NUMBER; k++) {
+			number |= (unsigned long) f << (k * BIG_STICKER_BITS);
+		}
+		for (i = 0; i < nfacenumbers; i++) {
+			cube->stickers[f * nfacenumbers + i] = number;
+		}
+		cube->turns[f] = 0;
+	}
+}
+
+/** Creates a solved cube of the given size (at least 2), returning false
+ * if there is not enough memory. */
+char init_big_cube(struct rubik_big_cube_st *cube, int size) {
+	long nfacenumbers;
+	cube->size = size;
+	cube->rownumbers = (size + BIG_STICKERS_PER_NUMBER - 1)
+		/ BIG_STICKERS_PER_NUMBER;
+	nfacenumbers = (long) size * cube->rownumbers;
+	cube->stickers = malloc(NFACES * nfacenumbers * sizeof(unsigned long));
+	cube->colors = malloc(4L * size);
+	if (cube->stickers == NULL || cube->colors == NULL) {
+		free(cube->stickers);
+		free(cube->colors);
+		return 0;
+	}
+	reset_big_cube(cube);
+	init_big_strips(cube);
+	return 1;
+}
+
+void free_big_cube(struct rubik_big_cube_st *cube) {
+	free(cube->stickers);
+	free(cube->colors);
+}
+
+/** Number with the sticker shown in the row and column of the face, undoing
+ * the quarter turns of the face, and the shift of the sticker in the number. */
+unsigned long *big_sticker_number(struct rubik_big_cube_st *cube, int face,
+		int row, int col, int *shift) {
+	int r, c, last = cube->size - 1;
+	switch (cube->turns[face]) {
+		case 0: r = row; c = col; break;
+		case 1: r = last - col; c = row; break;
+		case 2: r = last - row; c = last - col; break;
+		default: r = col; c = last - row; break;
+	}
+	*shift = (c % BIG_STICKERS_PER_NUMBER) * BIG_STICKER_BITS;
+	return cube->stickers + ((long) face * cube->size + r)
+		* cube->rownumbers + c / BIG_STICKERS_PER_NUMBER;
+}
+
+char get_big_sticker(struct rubik_big_cube_st *cube, int face,
+		int row, int col) {
+	int shift;
+	unsigned long *number = big_sticker_number(cube, face, row, col, &shift);
+	return (char) ((*number >> shift) & BIG_STICKER_MASK);
+}
+
+void set_big_sticker(struct rubik_big_cube_st *cube, int face,
+		int row, int col, char color) {
+	int shift;
+	unsigned long *number = big_sticker_number(cube, face, row, col, &shift);
+	*number = (*number & ~(BIG_STICKER_MASK << shift))
+		| ((unsigned long) color << shift);
+}
+
+/** Starts the line of the stickers of the face from the row and column shown
+ * advancing the given steps of rows and columns, undoing the quarter turns of
+ * the face to find the steps of the numbers. */
+void init_big_line(struct rubik_big_cube_st *cube, int face, int row, int col,
+		int rowstep, int colstep, struct rubik_big_line_st *line) {
+	int r, c;
+	line->number = big_sticker_number(cube, face, row, col, &line->shift);
+	switch (cube->turns[face]) {
+		case 0: r = rowstep; c = colstep; break;
+		case 1: r = -colstep; c = rowstep; break;
+		case 2: r = -rowstep; c = -colstep; break;
+		default: r = colstep; c = -rowstep; break;
+	}
+	line->shiftstep = c * BIG_STICKER_BITS;
+	line->numberstep = (long) r * cube->rownumbers;
+}
+
+/** Advances the line to its next sticker. */
+void next_big_line_sticker(struct rubik_big_line_st *line) {
+	if (line->shiftstep == 0) {
+		line->number += line->numberstep;
+		return;
+	}
+	line->shift += line->shiftstep;
+	if (line->shift < 0) {
+		line->number--;
+		line->shift = (BIG_STICKERS_PER_NUMBER - 1) * BIG_STICKER_BITS;
+	} else if (line->shift >= BIG_STICKERS_PER_NUMBER * BIG_STICKER_BITS) {
+		line->number++;
+		line->shift = 0;
+	}
+}
+
+/** Starts the line of the strip of an adjacent face moved by a turn of the
+ * layer of the given depth of the face. */
+void init_big_strip_line(struct rubik_big_cube_st *cube, int face, int depth,
+		int i, struct rubik_big_line_st *line) {
+	struct rubik_big_strip_st *strip = &cube->strips[face][i];
+	init_big_line(cube, ADJACENTS[face][i],
+		strip->row + strip->rowbydepth * depth,
+		strip->col + strip->colbydepth * depth,
+		strip->rowbystep, strip->colbystep, line);
+}
+
+/** Turns the layer of the given depth (0 for the face) of the given face
+ * any number of times, negative to do it in reverse, reading the 4 strips
+ * of the adjacent faces and writing each one in the strip of its turns. */
+void turn_big_cube_layer(struct rubik_big_cube_st *cube, char face,
+		int depth, int times) {
+	int quarters, i, t, opposite = OPPOSITES[(int) face];
+	char *colors;
+	struct rubik_big_line_st line;
+	quarters = (reduce_times(times) + 4) % 4;
+	if (! quarters) {
+		return;
+	}
+	for (i = 0; i < 4; i++) {
+		colors = cube->colors + (long) i * cube->size;
+		init_big_strip_line(cube, face, depth, i, &line);
+		for (t = 0; t < cube->size; t++) {
+			colors[t] = (char) ((*line.number >> line.shift)
+				& BIG_STICKER_MASK);
+			next_big_line_sticker(&line);
+		}
+	}
+	for (i = 0; i < 4; i++) {
+		colors = cube->colors + (long) i * cube->size;
+		init_big_strip_line(cube, face, depth, (i + quarters) % 4,
+				&line);
+		for (t = 0; t < cube->size; t++) {
+			*line.number = (*line.number
+				& ~(BIG_STICKER_MASK << line.shift))
+				| ((unsigned long) colors[t] << line.shift);
+			next_big_line_sticker(&line);
+		}
+	}
+	if (depth == 0) {
+		cube->turns[(int) face] = (cube->turns[(int) face] + quarters) % 4;
+	}
+	if (depth == cube->size - 1) {
+		cube->turns[opposite] = (cube->turns[opposite] + 4 - quarters) % 4;
+	}
+}
+
+/** Prints the stickers of the faces in the order of the facelets with the
+ * characters UFLRBD of their colors, which is the facelets for a 3x3x3. */
+void print_big_cube_point(struct rubik_big_cube_st *cube) {
+	int i, row, col, face;
+	printf("        ");
+	for (i = 0; i < NFACES; i++) {
+		face = FACELETS_FACES_ORDER[i];
+		for (row = 0; row < cube->size; row++) {
+			for (col = 0; col < cube->size; col++) {
+				putchar(FACELETS_COLOR_CHARS[(int)
+					get_big_sticker(cube, face, row, col)]);
+			}
+		}
+	}
+	putchar('\n');
+}
+
+/** Reads the stickers of the faces printed by print_big_cube_point, returning
+ * false if they are not 6 x N x N characters UFLRBD with N x N of each one. */
+char read_big_cube_point(struct rubik_big_cube_st *cube, char *point) {
+	int i, row, col, face;
+	long counts[NFACES];
+	char *p;
+	if ((long) strlen(point) != (long) NFACES * cube->size * cube->size) {
+		return 0;
+	}
+	for (i = 0; i < NFACES; i++) {
+		counts[i] = 0;
+		cube->turns[i] = 0;
+	}
+	for (i = 0; i < NFACES; i++) {
+		face = FACELETS_FACES_ORDER[i];
+		for (row = 0; row < cube->size; row++) {
+			for (col = 0; col < cube->size; col++) {
+				p = strchr(FACELETS_COLOR_CHARS, *point++);
+				if (p == NULL) {
+					return 0;
+				}
+				counts[p - FACELETS_COLOR_CHARS]++;
+				set_big_sticker(cube, face, row, col,
+					p - FACELETS_COLOR_CHARS);
+			}
+		}
+	}
+	for (i = 0; i < NFACES; i++) {
+		if (counts[i] != (long) cube->size * cube->size) {
+			return 0;
+		}
+	}
+	return 1;
+}
+
+void print_big_cube_row(struct rubik_big_cube_st *cube, int face, int row) {
+	int col;
+	for (col = 0; col < cube->size; col++) {
+		putchar(color_to_char(get_big_sticker(cube, face, row, col)));
+	}
+}
+
+/** Prints the faces unfolded, U over F, and L, F, R, B in a row over D. */
+void print_big_cube_net(struct rubik_big_cube_st *cube) {
+	int row, i, col, rowfaces[4] = {2, 1, 3, 4};
+	for (row = 0; row < cube->size; row++) {
+		printf("        ");
+		for (col = 0; col <= cube->size; col++) {
+			putchar(' ');
+		}
+		print_big_cube_row(cube, 0, row);
+		putchar('\n');
+	}
+	for (row = 0; row < cube->size; row++) {
+		printf("        ");
+		for (i = 0; i < 4; i++) {
+			if (i > 0) {
+				putchar(' ');
+			}
+			print_big_cube_row(cube, rowfaces[i], row);
+		}
+		putchar('\n');
+	}
+	for (row = 0; row < cube->size; row++) {
+		printf("        ");
+		for (col = 0; col <= cube->size; col++) {
+			putchar(' ');
+		}
+		print_big_cube_row(cube, 5, row);
+		putchar('\n');
+	}
+	putchar('\n');
+}
+
+/** Returns true if the argument has only decimal digits. */
+int valid_number_chars(char *arg) {
+	int i;
+	for (i = 0; arg[i] != '\0'; i++) {
+		if (! isdigit(arg[i])) {
+			return 0;
+		}
+	}
+	return i > 0;
+}
+
 #define APOS '\''
 #define QUOT '"'
 
@@ -583,6 +1292,18 @@ void println(char *str) {
 
 void print_help() {
 println("Use: rubik [-s|--silent] [-c|--chars UFLRBD] [-i|--initial POSITION]");
+println("           [-u|--undo] [--stats] [--record FILE]");
+println("           [--replay FILE [--seek MOVE]]");
+println("       rubik [-c|--chars UFLRBD] --simplify");
+println("       rubik [-c|--chars UFLRBD] --export FILE");
+println("       rubik --to-facelets|--from-facelets");
+println("       rubik --tables");
+println("       rubik [-c|--chars UFLRBD] --fuzz N");
+println("       rubik [-c|--chars UFLRBD] --group MOVES,MOVES...");
+println("       rubik --distance-bounds FILE [--budget MS]");
+println("           [--patterns FILE]");
+println("       rubik -n|--size N [-s|--silent] [-c|--chars UFLRBD]");
+println("           [-i|--initial STICKERS]");
 println("Shows a 3D representation of the Rubik's Cube in ASCII and");
 println("allows to turn its faces by default entering the digits 1-6.");
 println("");
@@ -590,6 +1311,41 @@ println("  -c,--chars UFLRBD     6 characters to represent the colors");
 println("  -i,--initial POSITION the 20 uppercase letters (A-X) printed after");
 println("                        each move to recover again the same position");
 println("  -s,--silent           prints only the POSITION and not the ASCII");
+println("  -u,--undo             allows to undo and redo the moves entering");
+println("                        < and >, to save the position entering !X");
+println("                        and to return to it entering @X, where X");
+println("                        is any character used as name");
+println("  --stats               prints after the POSITION the number of solved");
+println("                        minicubes, of minicubes in their position, a");
+println("                        digit with the solved minicubes of each face");
+println("                        and the number of faces solved");
+println("  --simplify            prints the moves of each line simplified");
+println("  --record FILE         saves the moves applied in a compact FILE");
+println("  --replay FILE         starts after the last move of a recorded FILE");
+println("  --seek MOVE           or after the given number of moves of FILE");
+println("  --export FILE         prints the moves of a recorded FILE");
+println("  -n,--size N           plays with a cube of NxNxN showing all its");
+println("                        STICKERS, entering (D) the next moves of the");
+println("                        line turn the layer D of the faces");
+println("  --group MOVES,...     prints the number of positions reachable with");
+println("                        the given sequences of moves, and then yes or");
+println("                        no for each POSITION of the input reachable");
+println("  --fuzz N              compares the engines of the cube with the");
+println("                        reference one after each move of N random");
+println("                        sequences and prints their moves per second");
+println("  --distance-bounds FILE prints the minimum and maximum number of");
+println("                        moves to solve each POSITION of FILE,");
+println("                        searching them up to --budget milliseconds");
+println("                        for each one (1000 by default)");
+println("  --patterns FILE       loads from FILE the distances of the patterns");
+println("                        used by --distance-bounds, or saves them in");
+println("                        FILE the first time after calculating them");
+println("  --tables              prints in C the tables used by the program");
+println("                        to include them as rubik_tables.h");
+println("  --to-facelets         converts each POSITION of the input to the");
+println("                        54 facelets URFDLB used by other programs");
+println("  --from-facelets       converts each line of 54 facelets of the");
+println("                        input to the POSITION of 20 letters");
 println("");
 println("Entering the character shown in the center of a face turns");
 println("that face clockwise one-quarter turn, entering N' turns the");
@@ -598,6 +1354,9 @@ println("the face N one-quarter turn two times. Applying these symbols");
 println("again to the same face or use them alone will have no effect,");
 println("and any other unrecognized symbol is also ignored.");
 println("");
+println("The moves of each line are simplified before applying them:");
+println("opposite faces turn independently, so 1 6 1' is only 6.");
+println("");
 }
 
 struct rubik_move_st {
@@ -690,13 +1449,2111 @@ char process_input_char(char c) {
 	return hasresult;
 }
 
-/* Remove #define NDEBUG to enable the tests. */
-#define NDEBUG
+/** Returns the minor of the face and its opposite, both turn around it. */
+char face_axis(char face) {
+	char opposite = OPPOSITES[(int) face];
+	return face < opposite ? face : opposite;
+}
 
-#ifndef NDEBUG
+/** Normalizes the sequence of moves in the same array returning its new size.
+ * Turns of opposite faces commute, so the consecutive turns of the same axis
+ * are merged by face, the null ones removed and the minor face placed first.
+ * Using the array as a stack, when a group of the same axis is removed, the
+ * previous group is of another axis, so the result can not be reduced more. */
+int simplify_moves(struct rubik_move_st *moves, int nmoves) {
+	int i, j, n, start, times, minortimes, majortimes;
+	char face, axis;
+	n = 0;
+	for (i = 0; i < nmoves; i++) {
+		face = moves[i].face;
+		times = moves[i].times;
+		axis = face_axis(face);
+		for (start = n; start > 0
+			&& face_axis(moves[start - 1].face) == axis; start--)
+			;
+		minortimes = majortimes = 0;
+		for (j = start; j < n; j++) {
+			if (moves[j].face == axis) {
+				minortimes += moves[j].times;
+			} else {
+				majortimes += moves[j].times;
+			}
+		}
+		if (face == axis) {
+			minortimes += times;
+		} else {
+			majortimes += times;
+		}
+		n = start;
+		if ((minortimes = reduce_times(minortimes)) != 0) {
+			moves[n].face = axis;
+			moves[n++].times = minortimes == -2 ? 2 : minortimes;
+		}
+		if ((majortimes = reduce_times(majortimes)) != 0) {
+			moves[n].face = OPPOSITES[(int) axis];
+			moves[n++].times = majortimes == -2 ? 2 : majortimes;
+		}
+	}
+	return n;
+}
 
-#include <assert.h>
-#define MAX_ITEST_RESULTS 5
+/** Prints the moves with the same notation of the input separated by spaces,
+ * the times of each move must be reduced. */
+void print_moves(struct rubik_move_st *moves, int nmoves) {
+	int i;
+	for (i = 0; i < nmoves; i++) {
+		if (i > 0) {
+			putchar(' ');
+		}
+		putchar(color_to_char(moves[i].face));
+		if (moves[i].times == -1) {
+			putchar(APOS);
+		} else if (moves[i].times == 2 || moves[i].times == -2) {
+			putchar(QUOT);
+		}
+	}
+}
+
+/* Format of the recordings of moves, all numbers are unsigned of 32 bits in
+little-endian order and aligned to 4 bytes, so the file can be also mapped
+in memory and accessed directly:
+  0: "RUBIKREC", 8: version, 12: moves by block (K), 16: number of moves,
+  20: number of blocks, 24: bytes of each block, 28: 0 (reserved),
+  32: the blocks, each one with the 20 letters of the position after the
+      moves of the previous blocks and then its K moves packed 7 by number
+      (4.57 bits each), the first move in the minor digit of base 18, where
+      each digit is the face by 3 plus 0 when the times are 1, plus 1 when
+      are -1 or plus 2 when are 2.
+So any move M is found in the number M % K / 7 of the block M / K, which
+starts with the nearest previous position. The file is only appended and
+the numbers of moves and blocks of the header are updated when a block is
+completed and when the recording is closed, so if the program is interrupted
+the file remains valid with the moves of the completed blocks. It admits up
+to 0xFFFFFFFF moves. */
+#define RECORD_MAGIC "RUBIKREC"
+#define RECORD_VERSION 2
+#define RECORD_HEADER_SIZE 32L
+#define RECORD_MOVES_PER_NUMBER 7
+#define RECORD_NSYMBOLS (NFACES * 3)
+#define RECORD_INTERVAL (RECORD_MOVES_PER_NUMBER * 128)
+#define RECORD_MAX_MOVES 0xFFFFFFFFUL
+
+/** State of a recording being written or read, with the number of moves
+ * being packed and the multiplier of the next move when it is written, or
+ * the last number read and its index when it is read. */
+struct rubik_record_st {
+	FILE *file;
+	unsigned long interval, nmoves, nsnapshots, blocksize;
+	unsigned long number, numberindex;
+};
+
+void write_record_number(FILE *file, unsigned long number) {
+	int i;
+	for (i = 0; i < 4; i++) {
+		putc((int) ((number >> (i * 8)) & 0xFF), file);
+	}
+}
+
+unsigned long read_record_number(FILE *file) {
+	int i;
+	unsigned long number = 0;
+	for (i = 0; i < 4; i++) {
+		number |= ((unsigned long) (getc(file) & 0xFF)) << (i * 8);
+	}
+	return number;
+}
+
+void write_record_header(struct rubik_record_st *rec) {
+	fwrite(RECORD_MAGIC, 1, strlen(RECORD_MAGIC), rec->file);
+	write_record_number(rec->file, RECORD_VERSION);
+	write_record_number(rec->file, rec->interval);
+	write_record_number(rec->file, rec->nmoves);
+	write_record_number(rec->file, rec->nsnapshots);
+	write_record_number(rec->file, rec->blocksize);
+	write_record_number(rec->file, 0);
+}
+
+/** Updates the numbers of moves and blocks of the header and returns to the
+ * end of the file, returning false if the file could not be written. */
+char update_record_header(struct rubik_record_st *rec) {
+	if (fseek(rec->file, 16L, SEEK_SET)) {
+		return 0;
+	}
+	write_record_number(rec->file, rec->nmoves);
+	write_record_number(rec->file, rec->nsnapshots);
+	return fseek(rec->file, 0L, SEEK_END) == 0 && ! ferror(rec->file);
+}
+
+void write_record_snapshot(FILE *file, char currentorients[NMINICUBES]) {
+	int i;
+	for (i = 0; i < NMINICUBES; i++) {
+		putc(currentorients[i] + 'A', file);
+	}
+}
+
+/** Creates the file of the recording and saves the initial position.
+ * Returns false if the file could not be created. */
+char open_record(struct rubik_record_st *rec, char *filename,
+		char currentorients[NMINICUBES]) {
+	if ((rec->file = fopen(filename, "wb")) == NULL) {
+		return 0;
+	}
+	rec->interval = RECORD_INTERVAL;
+	rec->blocksize = NMINICUBES
+		+ 4 * (RECORD_INTERVAL / RECORD_MOVES_PER_NUMBER);
+	rec->nmoves = 0;
+	rec->number = 0;
+	rec->numberindex = 1;
+	rec->nsnapshots = 1;
+	write_record_header(rec);
+	write_record_snapshot(rec->file, currentorients);
+	return fflush(rec->file) == 0;
+}
+
+/** Adds to the recording a move already applied to the given position,
+ * returning false if the recording has already the maximum of moves or
+ * the file could not be written. */
+char record_move(struct rubik_record_st *rec, struct rubik_move_st *move,
+		char currentorients[NMINICUBES]) {
+	int symbol = move->face * 3;
+	if (rec->nmoves == RECORD_MAX_MOVES) {
+		return 0;
+	}
+	if (move->times == -1) {
+		symbol += 1;
+	} else if (move->times != 1) {
+		symbol += 2;
+	}
+	rec->number += symbol * rec->numberindex;
+	rec->numberindex *= RECORD_NSYMBOLS;
+	if (++rec->nmoves % RECORD_MOVES_PER_NUMBER == 0) {
+		write_record_number(rec->file, rec->number);
+		rec->number = 0;
+		rec->numberindex = 1;
+	}
+	if (rec->nmoves % rec->interval == 0) {
+		write_record_snapshot(rec->file, currentorients);
+		rec->nsnapshots++;
+		return update_record_header(rec);
+	}
+	return 1;
+}
+
+/** Saves the pending moves, completes the header and closes the file.
+ * Returns false if the recording could not be written completely. */
+char close_record(struct rubik_record_st *rec) {
+	char ok;
+	if (rec->nmoves % RECORD_MOVES_PER_NUMBER != 0) {
+		write_record_number(rec->file, rec->number);
+	}
+	ok = update_record_header(rec);
+	return fclose(rec->file) == 0 && ok;
+}
+
+/** Opens a recording to read it, returning false if it is not valid. */
+char open_replay(struct rubik_record_st *rec, char *filename) {
+	char magic[sizeof(RECORD_MAGIC)];
+	if ((rec->file = fopen(filename, "rb")) == NULL) {
+		return 0;
+	}
+	magic[fread(magic, 1, strlen(RECORD_MAGIC), rec->file)] = '\0';
+	if (strcmp(magic, RECORD_MAGIC)
+			|| read_record_number(rec->file) != RECORD_VERSION) {
+		fclose(rec->file);
+		return 0;
+	}
+	rec->interval = read_record_number(rec->file);
+	rec->nmoves = read_record_number(rec->file);
+	rec->nsnapshots = read_record_number(rec->file);
+	rec->blocksize = read_record_number(rec->file);
+	rec->numberindex = (unsigned long) -1;
+	if (feof(rec->file) || rec->interval == 0
+			|| rec->interval % RECORD_MOVES_PER_NUMBER != 0
+			|| rec->blocksize != NMINICUBES + 4
+			* (rec->interval / RECORD_MOVES_PER_NUMBER)
+			|| rec->nsnapshots != rec->nmoves / rec->interval + 1) {
+		fclose(rec->file);
+		return 0;
+	}
+	return 1;
+}
+
+/** Reads the move of the given index of the recording, the number with the
+ * move is kept to read the next moves of the same number without the file. */
+char read_replay_move(struct rubik_record_st *rec, unsigned long index,
+		struct rubik_move_st *move) {
+	int symbol, d;
+	unsigned long number;
+	if (index / RECORD_MOVES_PER_NUMBER != rec->numberindex) {
+		rec->numberindex = index / RECORD_MOVES_PER_NUMBER;
+		if (fseek(rec->file, RECORD_HEADER_SIZE
+				+ (long) rec->blocksize * (index / rec->interval)
+				+ NMINICUBES + 4L * (index % rec->interval
+				/ RECORD_MOVES_PER_NUMBER), SEEK_SET)) {
+			return 0;
+		}
+		rec->number = read_record_number(rec->file);
+	}
+	number = rec->number;
+	for (d = index % RECORD_MOVES_PER_NUMBER; d > 0; d--) {
+		number /= RECORD_NSYMBOLS;
+	}
+	symbol = number % RECORD_NSYMBOLS;
+	move->face = symbol / 3;
+	move->times = symbol % 3 == 0 ? 1 : (symbol % 3 == 1 ? -1 : 2);
+	return ! feof(rec->file);
+}
+
+/** Restores the position after the given number of moves of the recording
+ * from the nearest previous snapshot, returning false if it is not valid. */
+char seek_replay(struct rubik_record_st *rec, unsigned long nmoves,
+		char currentorients[NMINICUBES],
+		char minicubesbypos[NMINICUBES]) {
+	unsigned long m;
+	char point[NMINICUBES + 1];
+	struct rubik_move_st move;
+	if (nmoves > rec->nmoves || fseek(rec->file, RECORD_HEADER_SIZE
+			+ (long) rec->blocksize * (nmoves / rec->interval),
+			SEEK_SET)) {
+		return 0;
+	}
+	point[fread(point, 1, NMINICUBES, rec->file)] = '\0';
+	if (! valid_cube_point_chars(point)
+	|| ! init_cube_point(currentorients, minicubesbypos, point)) {
+		return 0;
+	}
+	for (m = nmoves - nmoves % rec->interval; m < nmoves; m++) {
+		if (! read_replay_move(rec, m, &move)) {
+			return 0;
+		}
+		rotate_cube_face(move.face, move.times,
+				currentorients, minicubesbypos);
+	}
+	return 1;
+}
+
+/** Prints the moves of the recording, each K moves in a different line. */
+char export_replay(struct rubik_record_st *rec) {
+	unsigned long m;
+	struct rubik_move_st move;
+	for (m = 0; m < rec->nmoves; m++) {
+		if (! read_replay_move(rec, m, &move)) {
+			return 0;
+		}
+		if (m % rec->interval != 0) {
+			putchar(' ');
+		}
+		print_moves(&move, 1);
+		if ((m + 1) % rec->interval == 0 || m + 1 == rec->nmoves) {
+			putchar('\n');
+		}
+	}
+	return 1;
+}
+
+/** Each move applied is a node of the tree of the history that knows its
+ * previous node, the depth from the initial position and the last next node
+ * visited, which is the one followed to redo the move that was undone. */
+struct rubik_history_node_st {
+	int parent, lastchild, depth;
+	char face, times;
+};
+
+#define NBRANCHES 256
+#define INITIAL_HISTORY_NODES 1024
+
+/** History of the moves of the session, the node 0 is the initial position.
+ * Only the moves are saved, to go to another node the moves are undone
+ * until the common node and then redone by the last child nodes visited. */
+struct rubik_history_st {
+	struct rubik_history_node_st *nodes;
+	int nnodes, maxnodes, current, nundo, nredo;
+	int branches[NBRANCHES];
+};
+
+/** Creates the history with the initial node, returning false without memory. */
+char init_history(struct rubik_history_st *hist) {
+	int i;
+	hist->nodes = malloc(INITIAL_HISTORY_NODES * sizeof(*hist->nodes));
+	if (hist->nodes == NULL) {
+		return 0;
+	}
+	hist->maxnodes = INITIAL_HISTORY_NODES;
+	hist->nnodes = 1;
+	hist->current = hist->nundo = hist->nredo = 0;
+	hist->nodes[0].parent = hist->nodes[0].lastchild = -1;
+	hist->nodes[0].depth = 0;
+	hist->nodes[0].face = EMPTY_COLOR;
+	hist->nodes[0].times = 0;
+	for (i = 0; i < NBRANCHES; i++) {
+		hist->branches[i] = -1;
+	}
+	return 1;
+}
+
+void free_history(struct rubik_history_st *hist) {
+	free(hist->nodes);
+}
+
+/** Adds a move applied after the current node, returning false without memory.
+ * The nodes of the moves undone are kept, they could be in a branch. */
+char add_history_move(struct rubik_history_st *hist,
+		struct rubik_move_st *move) {
+	struct rubik_history_node_st *node;
+	if (hist->nnodes == hist->maxnodes) {
+		node = realloc(hist->nodes,
+			2 * hist->maxnodes * sizeof(*hist->nodes));
+		if (node == NULL) {
+			return 0;
+		}
+		hist->nodes = node;
+		hist->maxnodes *= 2;
+	}
+	node = &hist->nodes[hist->nnodes];
+	node->parent = hist->current;
+	node->lastchild = -1;
+	node->depth = hist->nodes[hist->current].depth + 1;
+	node->face = move->face;
+	node->times = move->times;
+	hist->nodes[hist->current].lastchild = hist->nnodes;
+	hist->current = hist->nnodes++;
+	return 1;
+}
+
+/** Prepares to undo the last move, returning false in the initial position. */
+char undo_history(struct rubik_history_st *hist) {
+	if (hist->current == 0) {
+		return 0;
+	}
+	hist->nundo = 1;
+	hist->nredo = 0;
+	return 1;
+}
+
+/** Prepares to redo the last move undone, returning false if there is none. */
+char redo_history(struct rubik_history_st *hist) {
+	if (hist->nodes[hist->current].lastchild == -1) {
+		return 0;
+	}
+	hist->nundo = 0;
+	hist->nredo = 1;
+	return 1;
+}
+
+/** Saves the current node with the given name, replacing any previous one. */
+void mark_history_branch(struct rubik_history_st *hist, char name) {
+	hist->branches[(unsigned char) name] = hist->current;
+}
+
+/** Prepares to go to the node saved with the given name, following the
+ * previous nodes of both until the common one, and marking the way back to
+ * the named node as the last visited. Returns false for an unknown name. */
+char goto_history_branch(struct rubik_history_st *hist, char name) {
+	int from, to;
+	struct rubik_history_node_st *nodes = hist->nodes;
+	if ((to = hist->branches[(unsigned char) name]) == -1) {
+		return 0;
+	}
+	from = hist->current;
+	hist->nundo = hist->nredo = 0;
+	while (from != to) {
+		if (nodes[from].depth >= nodes[to].depth) {
+			from = nodes[from].parent;
+			hist->nundo++;
+		} else {
+			nodes[nodes[to].parent].lastchild = to;
+			to = nodes[to].parent;
+			hist->nredo++;
+		}
+	}
+	return 1;
+}
+
+/** Returns in the argument the next move to apply to undo or redo the moves
+ * prepared before, updating the current node, or false if there is none. */
+char next_history_move(struct rubik_history_st *hist,
+		struct rubik_move_st *move) {
+	struct rubik_history_node_st *node;
+	if (hist->nundo > 0) {
+		hist->nundo--;
+		node = &hist->nodes[hist->current];
+		move->face = node->face;
+		move->times = node->times == 2 ? 2 : -node->times;
+		hist->current = node->parent;
+		return 1;
+	}
+	if (hist->nredo > 0) {
+		hist->nredo--;
+		hist->current = hist->nodes[hist->current].lastchild;
+		node = &hist->nodes[hist->current];
+		move->face = node->face;
+		move->times = node->times;
+		return 1;
+	}
+	return 0;
+}
+
+/* The subgroups of positions reachable with some sequences of moves are
+represented by the permutations of the 48 stickers that are not centers: the
+sticker I of a position is the one in the face CUBE_FACES_INDEXES[I][1] of the
+minicube in the position CUBE_FACES_INDEXES[I][0], and the value of the sticker
+I is the index of the sticker in the same face of the initial cube. Using the
+Schreier-Sims algorithm, each level I of the group has
+the stickers that its permutations can move to the place I, when the previous
+places are fixed, and one permutation for each one, so the order of the group
+is the product of the number of stickers of all levels, and a permutation
+belongs to the group if it can be fixed level by level with those ones. */
+#define NSTICKERS NVALUES_CUBE
+#define MAX_GROUP_GENERATORS 1024
+#define GENERATORS_SEPARATOR ','
+
+/** Index of the sticker of each face of each minicube, -1 if it has none. */
+void init_sticker_indexes(char stickerindexes[NMINICUBES][NFACES]) {
+	int i, f;
+	for (i = 0; i < NMINICUBES; i++) {
+		for (f = 0; f < NFACES; f++) {
+			stickerindexes[i][f] = -1;
+		}
+	}
+	for (i = 0; i < NSTICKERS; i++) {
+		stickerindexes[(int) CUBE_FACES_INDEXES[i][0]]
+			[(int) CUBE_FACES_INDEXES[i][1]] = i;
+	}
+}
+
+/** Permutation of the stickers of a position.
+ * Requires ORIENTATIONS[NORIENTS][NFACES], STICKER_INDEXES[NMINICUBES][NFACES].*/
+void cube_point_to_stickers(char currentorients[NMINICUBES],
+		char minicubesbypos[NMINICUBES], char stickers[NSTICKERS]) {
+	int i, mcidx;
+	const char *idx;
+	for (i = 0; i < NSTICKERS; i++) {
+		idx = CUBE_FACES_INDEXES[i];
+		mcidx = minicubesbypos[(int) idx[0]];
+		stickers[i] = STICKER_INDEXES[mcidx][(int) ORIENTATIONS
+			[(int) currentorients[mcidx]][(int) idx[1]]];
+	}
+}
+
+/** Levels of the group, with one permutation for each sticker that can be
+ * moved to the place of the level, or the first value -1 if there is none,
+ * and the generators found for each level. */
+struct rubik_group_st {
+	char transversals[NSTICKERS][NSTICKERS][NSTICKERS];
+	char generators[MAX_GROUP_GENERATORS][NSTICKERS];
+	int generatorlevels[MAX_GROUP_GENERATORS];
+	int ngenerators;
+};
+
+/** Initializes the group with only the identity. */
+void init_group(struct rubik_group_st *group) {
+	int level, i;
+	for (level = 0; level < NSTICKERS; level++) {
+		for (i = 0; i < NSTICKERS; i++) {
+			group->transversals[level][i][0] = -1;
+		}
+		for (i = 0; i < NSTICKERS; i++) {
+			group->transversals[level][level][i] = i;
+		}
+	}
+	group->ngenerators = 0;
+}
+
+/** Saves in result the permutation first applying second and then first. */
+void compose_stickers(char result[NSTICKERS], char first[NSTICKERS],
+		char second[NSTICKERS]) {
+	int i;
+	for (i = 0; i < NSTICKERS; i++) {
+		result[i] = first[(int) second[i]];
+	}
+}
+
+/** Removes from the permutation the permutations of the levels from the given
+ * one while possible, returning the level where it was not possible or
+ * NSTICKERS if only the identity remains. */
+int sift_group_stickers(struct rubik_group_st *group, int level,
+		char stickers[NSTICKERS]) {
+	int i;
+	char *transversal, inverse[NSTICKERS];
+	for (; level < NSTICKERS; level++) {
+		transversal = group->transversals[level][(int) stickers[level]];
+		if (transversal[0] == -1) {
+			return level;
+		}
+		for (i = 0; i < NSTICKERS; i++) {
+			inverse[(int) transversal[i]] = i;
+		}
+		for (i = 0; i < NSTICKERS; i++) {
+			stickers[i] = inverse[(int) stickers[i]];
+		}
+	}
+	return NSTICKERS;
+}
+
+char add_group_generator(struct rubik_group_st *group, int level,
+		char stickers[NSTICKERS]);
+
+/** Adds the permutation that moves the sticker of the level to a new place of
+ * the level, or tests that it belongs to the next levels if the place was
+ * already known. Returns false if there are too many generators. */
+char update_group_level(struct rubik_group_st *group, int level,
+		char stickers[NSTICKERS]) {
+	int i, next;
+	char *transversal, moved[NSTICKERS];
+	transversal = group->transversals[level][(int) stickers[level]];
+	if (transversal[0] != -1) {
+		memcpy(moved, stickers, NSTICKERS);
+		next = sift_group_stickers(group, level, moved);
+		return next == NSTICKERS
+			|| add_group_generator(group, next, moved);
+	}
+	memcpy(transversal, stickers, NSTICKERS);
+	for (i = 0; i < group->ngenerators; i++) {
+		if (group->generatorlevels[i] >= level) {
+			compose_stickers(moved, group->generators[i], transversal);
+			if (! update_group_level(group, level, moved)) {
+				return 0;
+			}
+		}
+	}
+	return 1;
+}
+
+/** Adds a generator that fixes the stickers of the previous levels and does
+ * not belong to the group of the level, which belongs also to the groups of
+ * the previous levels. Returns false if there are too many generators. */
+char add_group_generator(struct rubik_group_st *group, int level,
+		char stickers[NSTICKERS]) {
+	int i;
+	char *generator, moved[NSTICKERS];
+	if (group->ngenerators == MAX_GROUP_GENERATORS) {
+		return 0;
+	}
+	generator = group->generators[group->ngenerators];
+	memcpy(generator, stickers, NSTICKERS);
+	group->generatorlevels[group->ngenerators++] = level;
+	for (; level >= 0; level--) {
+		for (i = 0; i < NSTICKERS; i++) {
+			if (group->transversals[level][i][0] != -1) {
+				compose_stickers(moved, generator,
+					group->transversals[level][i]);
+				if (! update_group_level(group, level, moved)) {
+					return 0;
+				}
+			}
+		}
+	}
+	return 1;
+}
+
+/** Saves the permutation of the stickers of the position reached applying the
+ * moves of the string to the initial position.
+ * Requires the tables of init_cube_point and cube_point_to_stickers. */
+void moves_to_stickers(char *moves, char stickers[NSTICKERS]) {
+	char currentorients[NMINICUBES], minicubesbypos[NMINICUBES];
+	init_cube_point(currentorients, minicubesbypos, "AAAAAAAAAAAAAAAAAAAA");
+	init_input_state();
+	for (; ; moves++) {
+		if (process_input_char(*moves != '\0' ? *moves : '\n')) {
+			rotate_cube_face(ST.result.face,
+					reduce_times(ST.result.times),
+					currentorients, minicubesbypos);
+		}
+		if (*moves == '\0') {
+			if (process_input_char('\n')) {
+				rotate_cube_face(ST.result.face,
+						reduce_times(ST.result.times),
+						currentorients, minicubesbypos);
+			}
+			break;
+		}
+	}
+	cube_point_to_stickers(currentorients, minicubesbypos, stickers);
+}
+
+/** Adds to the group the position reached applying the moves of the string to
+ * the initial position. Returns false if there are too many generators. */
+char add_group_moves(struct rubik_group_st *group, char *moves) {
+	int level;
+	char stickers[NSTICKERS];
+	moves_to_stickers(moves, stickers);
+	level = sift_group_stickers(group, 0, stickers);
+	return level == NSTICKERS || add_group_generator(group, level, stickers);
+}
+
+/** Saves the order of the group, the product of the sizes of its levels, in
+ * a string of decimal digits because it can exceed any integer type. */
+void group_order(struct rubik_group_st *group, char order[NSTICKERS * 2 + 1]) {
+	int level, i, size, ndigits, carry;
+	char digits[NSTICKERS * 2];
+	digits[0] = 1;
+	ndigits = 1;
+	for (level = 0; level < NSTICKERS; level++) {
+		for (size = i = 0; i < NSTICKERS; i++) {
+			if (group->transversals[level][i][0] != -1) {
+				size++;
+			}
+		}
+		for (carry = i = 0; i < ndigits || carry; i++) {
+			carry += (i < ndigits ? digits[i] * size : 0);
+			digits[i] = carry % 10;
+			carry /= 10;
+		}
+		ndigits = i;
+	}
+	for (i = 0; ndigits > 0; i++) {
+		order[i] = '0' + digits[--ndigits];
+	}
+	order[i] = '\0';
+}
+
+void print_group_order(struct rubik_group_st *group) {
+	char order[NSTICKERS * 2 + 1];
+	group_order(group, order);
+	printf("        %s\n", order);
+}
+
+/** Creates the group generated by the sequences of moves separated by commas.
+ * Returns false if there are too many generators. */
+char init_group_moves(struct rubik_group_st *group, char *generators) {
+	char *separator;
+	init_group(group);
+	while ((separator = strchr(generators, GENERATORS_SEPARATOR)) != NULL) {
+		*separator = '\0';
+		if (! add_group_moves(group, generators)) {
+			return 0;
+		}
+		*separator = GENERATORS_SEPARATOR;
+		generators = separator + 1;
+	}
+	return add_group_moves(group, generators);
+}
+
+/** Prints yes or no for each position of the input that belongs or not to the
+ * group, or an empty line if the position is not valid. Returns false if any
+ * line was not valid. */
+char check_group_lines(struct rubik_group_st *group) {
+	int valid;
+	unsigned long nline;
+	char line[FACELETS_LINE_SIZE], allvalid;
+	char currentorients[NMINICUBES], minicubesbypos[NMINICUBES];
+	char stickers[NSTICKERS];
+	allvalid = 1;
+	for (nline = 1; (valid = read_line(stdin, line, sizeof(line))) != EOF;
+			nline++) {
+		if (valid && valid_cube_point_chars(line)
+		&& init_cube_point(currentorients, minicubesbypos, line)) {
+			cube_point_to_stickers(currentorients, minicubesbypos,
+					stickers);
+			puts(sift_group_stickers(group, 0, stickers)
+					== NSTICKERS ? "yes" : "no");
+		} else {
+			putchar('\n');
+			fprintf(stderr, "Invalid position in line %lu\n", nline);
+			allvalid = 0;
+		}
+	}
+	return allvalid;
+}
+
+/* The harness of engines applies the same sequences of moves to the reference
+engine rotate_cube_face and to each alternative engine, comparing the POSITION
+of both after each move, and measures then the moves per second of each one.
+The sequences mix random moves with adversarial ones: the same face turned any
+times (also 0 and more than 2), opposite faces alternated, and random moves
+followed by their inverse. A difference is reduced to a minimal sequence. */
+#define NFUZZ_ENGINES 4
+#define MAX_FUZZ_MOVES 64
+#define NFUZZ_BENCH_MOVES 4096
+#define FUZZ_SEED 2022
+
+/** State of the cube for any engine, each one uses only its own fields. */
+struct rubik_engine_cube_st {
+	char currentorients[NMINICUBES];
+	char minicubesbypos[NMINICUBES];
+	struct rubik_cube_stats_st stats;
+	struct rubik_big_cube_st big;
+};
+
+struct rubik_engine_st {
+	char *name;
+	void (*reset)(struct rubik_engine_cube_st *cube);
+	void (*turn)(struct rubik_engine_cube_st *cube, char face, int times);
+	/* Saves the orientations of the minicubes, false if not consistent. */
+	char (*point)(struct rubik_engine_cube_st *cube,
+			char currentorients[NMINICUBES]);
+};
+
+void reset_engine_cube(struct rubik_engine_cube_st *cube) {
+	init_cube_point(cube->currentorients, cube->minicubesbypos,
+			"AAAAAAAAAAAAAAAAAAAA");
+}
+
+void reset_tracked_engine_cube(struct rubik_engine_cube_st *cube) {
+	reset_engine_cube(cube);
+	init_cube_stats(&cube->stats, cube->currentorients,
+			cube->minicubesbypos);
+}
+
+void reset_big_engine_cube(struct rubik_engine_cube_st *cube) {
+	reset_big_cube(&cube->big);
+}
+
+void turn_engine_cube(struct rubik_engine_cube_st *cube, char face,
+		int times) {
+	rotate_cube_face(face, times, cube->currentorients,
+			cube->minicubesbypos);
+}
+
+void turn_reduced_engine_cube(struct rubik_engine_cube_st *cube, char face,
+		int times) {
+	rotate_cube_face(face, reduce_times(times), cube->currentorients,
+			cube->minicubesbypos);
+}
+
+void turn_tracked_engine_cube(struct rubik_engine_cube_st *cube, char face,
+		int times) {
+	rotate_tracked_cube_face(face, times, cube->currentorients,
+			cube->minicubesbypos, &cube->stats);
+}
+
+void turn_big_engine_cube(struct rubik_engine_cube_st *cube, char face,
+		int times) {
+	turn_big_cube_layer(&cube->big, face, 0, times);
+}
+
+char engine_cube_point(struct rubik_engine_cube_st *cube,
+		char currentorients[NMINICUBES]) {
+	memcpy(currentorients, cube->currentorients, NMINICUBES);
+	return 1;
+}
+
+/** Also checks that the statistics are the same counting them again. */
+char tracked_engine_cube_point(struct rubik_engine_cube_st *cube,
+		char currentorients[NMINICUBES]) {
+	struct rubik_cube_stats_st counted;
+	init_cube_stats(&counted, cube->currentorients, cube->minicubesbypos);
+	memcpy(currentorients, cube->currentorients, NMINICUBES);
+	return ! memcmp(&counted, &cube->stats, sizeof(counted));
+}
+
+/** Converts the stickers of the big cube of size 3 to the facelets. */
+char big_engine_cube_point(struct rubik_engine_cube_st *cube,
+		char currentorients[NMINICUBES]) {
+	int i, row, col, face;
+	char facelets[NFACELETS + 1], *p = facelets;
+	for (i = 0; i < NFACES; i++) {
+		face = FACELETS_FACES_ORDER[i];
+		for (row = 0; row < 3; row++) {
+			for (col = 0; col < 3; col++) {
+				*p++ = FACELETS_COLOR_CHARS[(int) get_big_sticker(
+						&cube->big, face, row, col)];
+			}
+		}
+	}
+	*p = '\0';
+	return facelets_to_cube_point(facelets, currentorients);
+}
+
+const struct rubik_engine_st ENGINES[NFUZZ_ENGINES] = {
+	{"reference", reset_engine_cube, turn_engine_cube, engine_cube_point},
+	{"reduced", reset_engine_cube, turn_reduced_engine_cube,
+		engine_cube_point},
+	{"tracked", reset_tracked_engine_cube, turn_tracked_engine_cube,
+		tracked_engine_cube_point},
+	{"big 3x3x3", reset_big_engine_cube, turn_big_engine_cube,
+		big_engine_cube_point}
+};
+
+/** Random number from 0 to n - 1. */
+int fuzz_random(int n) {
+	return rand() % n;
+}
+
+/** Random face and times of one of the moves entered: 1, -1 or 2. */
+void random_fuzz_move(struct rubik_move_st *move) {
+	move->face = fuzz_random(NFACES);
+	move->times = fuzz_random(3) - 1;
+	if (move->times == 0) {
+		move->times = 2;
+	}
+}
+
+/** Generates a sequence of moves of the given kind from 0 to 3. */
+int generate_fuzz_moves(struct rubik_move_st *moves, int kind) {
+	int i, nmoves = 1 + fuzz_random(MAX_FUZZ_MOVES);
+	char face = fuzz_random(NFACES);
+	if (kind == 3) {
+		nmoves = (nmoves + 1) / 2;
+	}
+	for (i = 0; i < nmoves; i++) {
+		if (kind == 1) {
+			moves[i].face = face;
+			moves[i].times = fuzz_random(13) - 6;
+		} else if (kind == 2) {
+			moves[i].face = (i % 2 ? OPPOSITES[(int) face] : face);
+			moves[i].times = fuzz_random(7) - 3;
+		} else {
+			random_fuzz_move(&moves[i]);
+		}
+	}
+	if (kind == 3) {
+		for (i = 0; i < nmoves; i++) {
+			moves[nmoves + i].face = moves[nmoves - 1 - i].face;
+			moves[nmoves + i].times = -moves[nmoves - 1 - i].times;
+		}
+		nmoves *= 2;
+	}
+	return nmoves;
+}
+
+/** Applies the moves to the reference engine and to the given one from the
+ * solved cube, returning the number of moves applied until their POSITIONS
+ * differ, or 0 if they are the same after every move. */
+int run_fuzz_moves(const struct rubik_engine_st *engine,
+		struct rubik_engine_cube_st *refcube,
+		struct rubik_engine_cube_st *cube,
+		struct rubik_move_st *moves, int nmoves) {
+	int m;
+	char refpoint[NMINICUBES + 1], point[NMINICUBES + 1];
+	char currentorients[NMINICUBES];
+	ENGINES[0].reset(refcube);
+	engine->reset(cube);
+	for (m = 0; m < nmoves; m++) {
+		ENGINES[0].turn(refcube, moves[m].face, moves[m].times);
+		engine->turn(cube, moves[m].face, moves[m].times);
+		ENGINES[0].point(refcube, currentorients);
+		cube_point_chars(currentorients, refpoint);
+		if (! engine->point(cube, currentorients)) {
+			return m + 1;
+		}
+		cube_point_chars(currentorients, point);
+		if (strcmp(refpoint, point)) {
+			return m + 1;
+		}
+	}
+	return 0;
+}
+
+/** Times tried for each move of a sequence that fails, simplest first. */
+const int SHRINK_TIMES[4] = {1, -1, 2, -2};
+
+/** Reduces a sequence of moves that fails to a minimal one, removing moves
+ * while it fails and then simplifying their times. Returns its new length. */
+int shrink_fuzz_moves(const struct rubik_engine_st *engine,
+		struct rubik_engine_cube_st *refcube,
+		struct rubik_engine_cube_st *cube,
+		struct rubik_move_st *moves, int nmoves) {
+	int i, j, t, removed;
+	struct rubik_move_st move;
+	nmoves = run_fuzz_moves(engine, refcube, cube, moves, nmoves);
+	do {
+		removed = 0;
+		for (i = 0; i < nmoves; i++) {
+			move = moves[i];
+			for (j = i; j + 1 < nmoves; j++) {
+				moves[j] = moves[j + 1];
+			}
+			t = run_fuzz_moves(engine, refcube, cube,
+					moves, nmoves - 1);
+			if (t) {
+				nmoves = t;
+				removed = 1;
+				i--;
+			} else {
+				for (j = nmoves - 1; j > i; j--) {
+					moves[j] = moves[j - 1];
+				}
+				moves[i] = move;
+			}
+		}
+	} while (removed);
+	for (i = 0; i < nmoves; i++) {
+		for (j = 0; j < 4 && moves[i].times != SHRINK_TIMES[j]; j++) {
+			move = moves[i];
+			moves[i].times = SHRINK_TIMES[j];
+			if (run_fuzz_moves(engine, refcube, cube,
+						moves, nmoves)) {
+				break;
+			}
+			moves[i] = move;
+		}
+	}
+	return nmoves;
+}
+
+void print_fuzz_moves(struct rubik_move_st *moves, int nmoves) {
+	int i;
+	for (i = 0; i < nmoves; i++) {
+		printf(i > 0 ? " %c%+d" : "%c%+d",
+			color_to_char(moves[i].face), moves[i].times);
+	}
+	putchar('\n');
+}
+
+/** Applies the same random moves to the engine until a fourth of a second
+ * is consumed, returning the number of moves applied by second. */
+double bench_fuzz_engine(const struct rubik_engine_st *engine,
+		struct rubik_engine_cube_st *cube,
+		struct rubik_move_st *moves) {
+	int m;
+	unsigned long nmoves = 0;
+	clock_t start, elapsed;
+	engine->reset(cube);
+	start = clock();
+	do {
+		for (m = 0; m < NFUZZ_BENCH_MOVES; m++) {
+			engine->turn(cube, moves[m].face, moves[m].times);
+		}
+		nmoves += NFUZZ_BENCH_MOVES;
+		elapsed = clock() - start;
+	} while (elapsed < CLOCKS_PER_SEC / 4);
+	return nmoves / ((double) elapsed / CLOCKS_PER_SEC);
+}
+
+/** Compares each engine with the reference one applying the given number of
+ * sequences of moves, printing the minimal sequence that fails for each one,
+ * and prints the moves by second of all, returning false if any failed. */
+char fuzz_engines(unsigned long nsequences) {
+	int e, nmoves;
+	unsigned long s;
+	char allequal = 1;
+	double refspeed, speed;
+	struct rubik_move_st moves[MAX_FUZZ_MOVES * 2];
+	static struct rubik_move_st benchmoves[NFUZZ_BENCH_MOVES];
+	struct rubik_engine_cube_st cubes[NFUZZ_ENGINES];
+	for (e = 0; e < NFUZZ_ENGINES; e++) {
+		if (! init_big_cube(&cubes[e].big, 3)) {
+			while (--e >= 0) {
+				free_big_cube(&cubes[e].big);
+			}
+			fprintf(stderr, "Not enough memory for the cube\n");
+			return 0;
+		}
+	}
+	for (e = 1; e < NFUZZ_ENGINES; e++) {
+		srand(FUZZ_SEED);
+		for (s = 0; s < nsequences; s++) {
+			nmoves = generate_fuzz_moves(moves, s % 4);
+			if (run_fuzz_moves(&ENGINES[e], &cubes[0], &cubes[e],
+						moves, nmoves)) {
+				nmoves = shrink_fuzz_moves(&ENGINES[e],
+					&cubes[0], &cubes[e], moves, nmoves);
+				printf("%-10s differs after: ", ENGINES[e].name);
+				print_fuzz_moves(moves, nmoves);
+				allequal = 0;
+				break;
+			}
+		}
+		if (s == nsequences) {
+			printf("%-10s equal in %lu sequences\n",
+				ENGINES[e].name, nsequences);
+		}
+	}
+	for (s = 0; s < NFUZZ_BENCH_MOVES; s++) {
+		random_fuzz_move(&benchmoves[s]);
+	}
+	printf("%-10s %12s %8s\n", "ENGINE", "MOVES/S", "RELATIVE");
+	refspeed = 0;
+	for (e = 0; e < NFUZZ_ENGINES; e++) {
+		speed = bench_fuzz_engine(&ENGINES[e], &cubes[e], benchmoves);
+		if (e == 0) {
+			refspeed = speed;
+		}
+		printf("%-10s %12.0f %8.2f\n", ENGINES[e].name, speed,
+			speed / refspeed);
+	}
+	for (e = 0; e < NFUZZ_ENGINES; e++) {
+		free_big_cube(&cubes[e].big);
+	}
+	return allequal;
+}
+
+/* The bounds of the distance of a position to the solved cube count each turn
+of a face (quarter or half) as one move. They use the cubies of the position
+with the conventions of the two-phase algorithm of Kociemba: the number of
+each corner and edge in each position, numbered in the order of CORNER_NAMES
+and EDGE_NAMES, and their orientations, which do not change with the moves
+of the subgroup G1 of the turns of U and D and the half turns of the rest.
+The coordinates of the orientations of the corners (twist) and the edges
+(flip), the positions of the 4 edges between U and D with their order (slice)
+and the permutation of the corners or of the other 8 edges are turned with
+tables of moves, and tables of patterns keep the distance to their solved
+values of pairs of coordinates, found with breadth-first searches.
+
+The upper bound is the shortest solution found by the two-phase algorithm
+during half of the budget: an iterative deepening search reaches G1 with the
+patterns of twist or flip and the slice without order, and then another one
+solves it with the moves of G1 and the patterns of the permutations of the
+corners or the edges and the order of the slice, trying longer first phases
+while they can give shorter solutions. Then an iterative deepening search
+raises the lower bound with each depth completed, until it finds a solution,
+which is the exact distance, or the rest of the budget is consumed. Its lower
+bound is the greatest distance of the patterns of all the corners, of the
+flip and the slice and of the twist and the slice, seen also from the axes
+R-L and F-B with the rotation of the corners URF and DBL. The patterns take
+some seconds to calculate, so they can be saved in a file to load them the
+next times. The bounds of each position are saved in a cache of positions
+reduced by the 48 symmetries of the cube (rotated or seen in a mirror the
+distance is the same), so the next positions reuse the work done for the
+previous ones. Any position is solved in 20 moves or less. */
+#define MAX_DISTANCE 20
+#define MAX_DISTANCE_PATH (MAX_DISTANCE * 2)
+#define NCORNERS 8
+#define NEDGES 12
+#define NSLICE_EDGES 4
+#define FIRST_SLICE_EDGE (NEDGES - NSLICE_EDGES)
+#define NDISTANCE_MOVES (NFACES * 3)
+#define NDISTANCE_AXES 3
+#define NTWISTS 2187 /* 3^7 */
+#define NFLIPS 2048 /* 2^11 */
+#define NSLICES 495 /* 12! / (8! 4!) */
+#define NSLICE_PERMS 24 /* 4! */
+#define NSORTED_SLICES (NSLICES * NSLICE_PERMS)
+#define NCORNER_PERMS 40320L /* 8! */
+#define NUD_EDGE_PERMS 40320L /* 8! */
+#define NDISTANCE_COORDS 5
+#define TWIST_COORD 0
+#define FLIP_COORD 1
+#define SLICE_COORD 2
+#define CORNERS_COORD 3
+#define UD_EDGES_COORD 4 /* only with the moves of G1 */
+#define NDISTANCE_PATTERNS 6
+#define TWIST_SLICE_PATTERN 0
+#define FLIP_SLICE_PATTERN 1
+#define CORNERS_SLICE_PATTERN 2 /* only with the moves of G1 */
+#define UD_EDGES_SLICE_PATTERN 3 /* only with the moves of G1 */
+#define CORNERS_PATTERN 4
+#define EDGES_PATTERN 5
+#define UNKNOWN_DISTANCE 15
+#define PATTERNS_MAGIC "RUBIKPAT"
+#define PATTERNS_VERSION 2
+#define NSYMMETRIES 48
+#define DISTANCE_CACHE_SIZE 65536L
+#define DISTANCE_CLOCK_NODES 1024
+#define DEFAULT_DISTANCE_BUDGET 1000
+
+/** Number of the corner or edge in each position and its orientation. */
+struct rubik_cubies_st {
+	char cp[NCORNERS], co[NCORNERS];
+	char ep[NEDGES], eo[NEDGES];
+};
+
+struct rubik_distance_cache_st {
+	char stickers[NSTICKERS];
+	char lower;
+	char upper;
+	char used;
+};
+
+struct rubik_distance_st {
+	unsigned short *coordmoves[NDISTANCE_COORDS];
+	unsigned char *patterns[NDISTANCE_PATTERNS];
+	struct rubik_cubies_st movecubies[NDISTANCE_MOVES];
+	struct rubik_cubies_st root; /* position searched */
+	char axismoves[NDISTANCE_AXES][NDISTANCE_MOVES]; /* -1 if not found */
+	char symmetries[NSYMMETRIES][NSTICKERS];
+	struct rubik_distance_cache_st *cache;
+	char path[MAX_DISTANCE_PATH]; /* moves being searched */
+	char solution[MAX_DISTANCE_PATH]; /* moves of the upper bound */
+	int nsolution, upper, lower;
+	clock_t deadline;
+	unsigned long nodes;
+	char timeout;
+};
+
+/** Facelets of each corner and edge position, starting with the face U or D
+ * for the corners (clockwise) and the edges of U and D, and with the face F
+ * or B for the edges between them, which give their orientation. */
+const char CORNER_FACELETS[NCORNERS][3] = {
+	{8, 9, 20}, {6, 18, 38}, {0, 36, 47}, {2, 45, 11},
+	{29, 26, 15}, {27, 44, 24}, {33, 53, 42}, {35, 17, 51}
+};
+const char EDGE_FACELETS[NEDGES][2] = {
+	{5, 10}, {7, 19}, {3, 37}, {1, 46}, {32, 16}, {28, 25},
+	{30, 43}, {34, 52}, {23, 12}, {21, 41}, {50, 39}, {48, 14}
+};
+const char *CORNER_NAMES[NCORNERS] = {
+	"URF", "UFL", "ULB", "UBR", "DFR", "DLF", "DBL", "DRB"
+};
+const char *EDGE_NAMES[NEDGES] = {
+	"UR", "UF", "UL", "UB", "DR", "DF", "DL", "DB", "FR", "FL", "BL", "BR"
+};
+
+/** Rotation of 120 degrees around the corners URF and DBL, which moves the
+ * face U to R, R to F and F to U. */
+const struct rubik_cubies_st URF_ROTATION = {
+	{0, 4, 5, 1, 3, 7, 6, 2}, {1, 2, 1, 2, 2, 1, 2, 1},
+	{1, 8, 5, 9, 3, 11, 7, 10, 0, 4, 6, 2},
+	{1, 0, 1, 0, 1, 0, 1, 0, 1, 1, 1, 1}
+};
+
+/** Times of each move of a face, the move is the face by 3 plus its index,
+ * like the symbols of the recordings. */
+const int DISTANCE_MOVE_TIMES[3] = {1, -1, 2};
+
+/** Returns true if the move is in G1. */
+char is_g1_distance_move(int move) {
+	return move / 3 == 0 || move / 3 == 5 || move % 3 == 2;
+}
+
+/** Returns true if the move turns the last face turned, or its opposite face
+ * when it is minor, which always gives positions reachable with less or the
+ * same moves in another order. */
+char is_redundant_distance_move(int move, int lastface) {
+	int face = move / 3;
+	return lastface != -1 && (face == lastface
+		|| (face == OPPOSITES[lastface] && face < lastface));
+}
+
+/** Saves in result the cubies of first followed by second. */
+void multiply_cubies(const struct rubik_cubies_st *first,
+		const struct rubik_cubies_st *second,
+		struct rubik_cubies_st *result) {
+	int i;
+	for (i = 0; i < NCORNERS; i++) {
+		result->cp[i] = first->cp[(int) second->cp[i]];
+		result->co[i] = (first->co[(int) second->cp[i]]
+				+ second->co[i]) % 3;
+	}
+	for (i = 0; i < NEDGES; i++) {
+		result->ep[i] = first->ep[(int) second->ep[i]];
+		result->eo[i] = (first->eo[(int) second->ep[i]]
+				+ second->eo[i]) % 2;
+	}
+}
+
+/** Cubies of the position, read from its facelets. */
+void cube_point_to_cubies(char currentorients[NMINICUBES],
+		char minicubesbypos[NMINICUBES],
+		struct rubik_cubies_st *cubies) {
+	int i, j, o;
+	const char *f;
+	char facelets[NFACELETS + 2];
+	cube_point_to_facelets(currentorients, minicubesbypos, facelets);
+	for (i = 0; i < NCORNERS; i++) {
+		f = CORNER_FACELETS[i];
+		for (o = 0; facelets[(int) f[o]] != 'U'
+				&& facelets[(int) f[o]] != 'D'; o++)
+			;
+		for (j = 0; CORNER_NAMES[j][1] != facelets[(int) f[(o + 1) % 3]]
+			|| CORNER_NAMES[j][2] != facelets[(int) f[(o + 2) % 3]];
+				j++)
+			;
+		cubies->cp[i] = j;
+		cubies->co[i] = o;
+	}
+	for (i = 0; i < NEDGES; i++) {
+		f = EDGE_FACELETS[i];
+		for (j = 0; j < NEDGES; j++) {
+			if (EDGE_NAMES[j][0] == facelets[(int) f[0]]
+			&& EDGE_NAMES[j][1] == facelets[(int) f[1]]) {
+				cubies->eo[i] = 0;
+				break;
+			}
+			if (EDGE_NAMES[j][1] == facelets[(int) f[0]]
+			&& EDGE_NAMES[j][0] == facelets[(int) f[1]]) {
+				cubies->eo[i] = 1;
+				break;
+			}
+		}
+		cubies->ep[i] = j;
+	}
+}
+
+/** Saves the minicubes of each position from their orientations. */
+void init_minicubes_by_position(char currentorients[NMINICUBES],
+		char minicubesbypos[NMINICUBES]) {
+	int i;
+	for (i = 0; i < NMINICUBES; i++) {
+		minicubesbypos[(int) POSITIONS_BY_ORIENT[i]
+			[(int) currentorients[i]]] = i;
+	}
+}
+
+/** Cubies of the solved cube. */
+void init_solved_cubies(struct rubik_cubies_st *cubies) {
+	char currentorients[NMINICUBES], minicubesbypos[NMINICUBES];
+	memset(currentorients, 0, NMINICUBES);
+	init_minicubes_by_position(currentorients, minicubesbypos);
+	cube_point_to_cubies(currentorients, minicubesbypos, cubies);
+}
+
+/** Rank of the permutation of n different numbers counting for each number
+ * the minor numbers after it, 0 when they are in order. */
+long rank_distance_permutation(const char *numbers, int n) {
+	int k, j, minors;
+	long index = 0;
+	for (k = 0; k < n; k++) {
+		for (j = k + 1, minors = 0; j < n; j++) {
+			minors += (numbers[j] < numbers[k]);
+		}
+		index = index * (n - k) + minors;
+	}
+	return index;
+}
+
+long binomial(int n, int k) {
+	long result = 1;
+	int i;
+	if (k > n) {
+		return 0;
+	}
+	for (i = 1; i <= k; i++) {
+		result = result * (n - k + i) / i;
+	}
+	return result;
+}
+
+/** Value of the coordinate of the cubies, 0 when they are solved. The slice
+ * is the combination of the positions of its edges by 24 plus their order,
+ * so its combination is 0 in G1. */
+long cubies_coordinate(int coord, const struct rubik_cubies_st *cubies) {
+	int i, n;
+	long index = 0;
+	char slice[NSLICE_EDGES];
+	switch (coord) {
+	case TWIST_COORD:
+		for (i = 0; i < NCORNERS - 1; i++) {
+			index = index * 3 + cubies->co[i];
+		}
+		return index;
+	case FLIP_COORD:
+		for (i = 0; i < NEDGES - 1; i++) {
+			index = index * 2 + cubies->eo[i];
+		}
+		return index;
+	case SLICE_COORD:
+		for (i = NEDGES - 1, n = 0; i >= 0; i--) {
+			if (cubies->ep[i] >= FIRST_SLICE_EDGE) {
+				index += binomial(NEDGES - 1 - i, n + 1);
+				slice[NSLICE_EDGES - 1 - n++] = cubies->ep[i];
+			}
+		}
+		return index * NSLICE_PERMS
+			+ rank_distance_permutation(slice, NSLICE_EDGES);
+	case CORNERS_COORD:
+		return rank_distance_permutation(cubies->cp, NCORNERS);
+	default:
+		return rank_distance_permutation(cubies->ep, FIRST_SLICE_EDGE);
+	}
+}
+
+/** Number of different values of each coordinate. */
+const long DISTANCE_COORD_SIZES[NDISTANCE_COORDS] = {
+	NTWISTS, NFLIPS, NSORTED_SLICES, NCORNER_PERMS, NUD_EDGE_PERMS
+};
+
+/** Value of each coordinate after each move, with a breadth-first search
+ * keeping the cubies of the first position found for each value. Returns
+ * false if there is not enough memory. */
+char init_distance_coord_moves(struct rubik_distance_st *dist, int coord) {
+	int m;
+	long head, tail, size, index, newindex;
+	char *found;
+	unsigned short *table = dist->coordmoves[coord];
+	struct rubik_cubies_st *queue, moved;
+	size = DISTANCE_COORD_SIZES[coord];
+	queue = malloc(size * sizeof(*queue));
+	found = calloc(size, 1);
+	if (queue == NULL || found == NULL) {
+		free(queue);
+		free(found);
+		return 0;
+	}
+	init_solved_cubies(&queue[0]);
+	found[cubies_coordinate(coord, &queue[0])] = 1;
+	for (head = 0, tail = 1; head < tail; head++) {
+		index = cubies_coordinate(coord, &queue[head]);
+		for (m = 0; m < NDISTANCE_MOVES; m++) {
+			if (coord == UD_EDGES_COORD
+			&& ! is_g1_distance_move(m)) {
+				continue;
+			}
+			multiply_cubies(&queue[head], &dist->movecubies[m],
+					&moved);
+			newindex = cubies_coordinate(coord, &moved);
+			table[index * NDISTANCE_MOVES + m] = newindex;
+			if (! found[newindex]) {
+				found[newindex] = 1;
+				queue[tail++] = moved;
+			}
+		}
+	}
+	free(queue);
+	free(found);
+	return 1;
+}
+
+/** Number of different indexes of each pattern. */
+const long DISTANCE_PATTERN_SIZES[NDISTANCE_PATTERNS] = {
+	NTWISTS * NSLICES, NFLIPS * NSLICES, NCORNER_PERMS * NSLICE_PERMS,
+	NUD_EDGE_PERMS * NSLICE_PERMS, NTWISTS * NCORNER_PERMS,
+	NFLIPS * NSORTED_SLICES
+};
+
+/** Index of the given pattern of the coordinates of a position. */
+long distance_pattern_index(int pattern, const long coords[NDISTANCE_COORDS]) {
+	switch (pattern) {
+	case TWIST_SLICE_PATTERN:
+		return coords[TWIST_COORD] * NSLICES
+			+ coords[SLICE_COORD] / NSLICE_PERMS;
+	case FLIP_SLICE_PATTERN:
+		return coords[FLIP_COORD] * NSLICES
+			+ coords[SLICE_COORD] / NSLICE_PERMS;
+	case CORNERS_SLICE_PATTERN:
+		return coords[CORNERS_COORD] * NSLICE_PERMS
+			+ coords[SLICE_COORD] % NSLICE_PERMS;
+	case UD_EDGES_SLICE_PATTERN:
+		return coords[UD_EDGES_COORD] * NSLICE_PERMS
+			+ coords[SLICE_COORD] % NSLICE_PERMS;
+	case CORNERS_PATTERN:
+		return coords[TWIST_COORD] * NCORNER_PERMS
+			+ coords[CORNERS_COORD];
+	default:
+		return coords[FLIP_COORD] * NSORTED_SLICES
+			+ coords[SLICE_COORD];
+	}
+}
+
+/** Index of the pattern after the move, turning the coordinates that give
+ * the index, with the slice in G1 for the patterns of G1. */
+long move_distance_pattern(struct rubik_distance_st *dist, int pattern,
+		long index, int move) {
+	long coords[NDISTANCE_COORDS];
+	int first, second;
+	switch (pattern) {
+	case TWIST_SLICE_PATTERN:
+	case FLIP_SLICE_PATTERN:
+		first = pattern == TWIST_SLICE_PATTERN ? TWIST_COORD
+			: FLIP_COORD;
+		coords[first] = index / NSLICES;
+		coords[SLICE_COORD] = index % NSLICES * NSLICE_PERMS;
+		second = SLICE_COORD;
+		break;
+	case CORNERS_SLICE_PATTERN:
+	case UD_EDGES_SLICE_PATTERN:
+		first = pattern == CORNERS_SLICE_PATTERN ? CORNERS_COORD
+			: UD_EDGES_COORD;
+		coords[first] = index / NSLICE_PERMS;
+		coords[SLICE_COORD] = index % NSLICE_PERMS;
+		second = SLICE_COORD;
+		break;
+	case CORNERS_PATTERN:
+		first = TWIST_COORD;
+		coords[first] = index / NCORNER_PERMS;
+		coords[CORNERS_COORD] = index % NCORNER_PERMS;
+		second = CORNERS_COORD;
+		break;
+	default:
+		first = FLIP_COORD;
+		coords[first] = index / NSORTED_SLICES;
+		coords[SLICE_COORD] = index % NSORTED_SLICES;
+		second = SLICE_COORD;
+		break;
+	}
+	coords[first] = dist->coordmoves[first][coords[first]
+		* NDISTANCE_MOVES + move];
+	coords[second] = dist->coordmoves[second][coords[second]
+		* NDISTANCE_MOVES + move];
+	return distance_pattern_index(pattern, coords);
+}
+
+/** Distance of the index of the pattern, kept in 4 bits. */
+int get_distance_pattern(const unsigned char *table, long index) {
+	return table[index / 2] >> (index % 2 * 4) & 0xF;
+}
+
+void set_distance_pattern(unsigned char *table, long index, int distance) {
+	table[index / 2] = (table[index / 2] & (0xF0 >> (index % 2 * 4)))
+		| distance << (index % 2 * 4);
+}
+
+/** Distance to the solved cube of each index of the pattern, with a
+ * breadth-first search that finds each depth from the previous one, or
+ * from the indexes not found yet when they are less than the found ones. */
+void init_distance_pattern(struct rubik_distance_st *dist, int pattern) {
+	int m, depth, g1;
+	long index, moved, size, nfound, nnew;
+	unsigned char *table = dist->patterns[pattern];
+	size = DISTANCE_PATTERN_SIZES[pattern];
+	g1 = (pattern == CORNERS_SLICE_PATTERN
+		|| pattern == UD_EDGES_SLICE_PATTERN);
+	memset(table, 0xFF, (size + 1) / 2);
+	set_distance_pattern(table, 0, 0);
+	for (depth = 0, nfound = 1; nfound < size; depth++, nfound += nnew) {
+		for (index = nnew = 0; index < size; index++) {
+			if (nfound < size / 2) {
+				if (get_distance_pattern(table, index)
+						!= depth) {
+					continue;
+				}
+				for (m = 0; m < NDISTANCE_MOVES; m++) {
+					if (g1 && ! is_g1_distance_move(m)) {
+						continue;
+					}
+					moved = move_distance_pattern(dist,
+							pattern, index, m);
+					if (get_distance_pattern(table, moved)
+							== UNKNOWN_DISTANCE) {
+						set_distance_pattern(table,
+							moved, depth + 1);
+						nnew++;
+					}
+				}
+			} else if (get_distance_pattern(table, index)
+					== UNKNOWN_DISTANCE) {
+				for (m = 0; m < NDISTANCE_MOVES; m++) {
+					if (g1 && ! is_g1_distance_move(m)) {
+						continue;
+					}
+					moved = move_distance_pattern(dist,
+							pattern, index, m);
+					if (get_distance_pattern(table, moved)
+							== depth) {
+						set_distance_pattern(table,
+							index, depth + 1);
+						nnew++;
+						break;
+					}
+				}
+			}
+		}
+		if (nnew == 0) {
+			break;
+		}
+	}
+}
+
+/** Calculates the distances of all the patterns. */
+void init_distance_patterns(struct rubik_distance_st *dist) {
+	int p;
+	for (p = 0; p < NDISTANCE_PATTERNS; p++) {
+		init_distance_pattern(dist, p);
+	}
+}
+
+/* Format of the file of the distances of the patterns, with the numbers like
+in the recordings: "RUBIKPAT", version, number of patterns, the number of
+indexes of each pattern and then the distances of each pattern, 4 bits for
+each index starting with the minor bits. */
+
+/** Loads the distances of the patterns from the file, returning false if it
+ * does not exist or it is not valid. */
+char load_distance_patterns(struct rubik_distance_st *dist, char *filename) {
+	int p;
+	size_t nbytes;
+	char magic[sizeof(PATTERNS_MAGIC)], valid;
+	FILE *file;
+	if ((file = fopen(filename, "rb")) == NULL) {
+		return 0;
+	}
+	magic[fread(magic, 1, strlen(PATTERNS_MAGIC), file)] = '\0';
+	valid = ! strcmp(magic, PATTERNS_MAGIC)
+		&& read_record_number(file) == PATTERNS_VERSION
+		&& read_record_number(file) == NDISTANCE_PATTERNS;
+	for (p = 0; p < NDISTANCE_PATTERNS && valid; p++) {
+		valid = read_record_number(file)
+			== (unsigned long) DISTANCE_PATTERN_SIZES[p];
+	}
+	for (p = 0; p < NDISTANCE_PATTERNS && valid; p++) {
+		nbytes = (DISTANCE_PATTERN_SIZES[p] + 1) / 2;
+		valid = fread(dist->patterns[p], 1, nbytes, file) == nbytes;
+	}
+	fclose(file);
+	return valid;
+}
+
+/** Saves the distances of the patterns in the file, returning false if it
+ * could not be written. */
+char save_distance_patterns(struct rubik_distance_st *dist, char *filename) {
+	int p;
+	char ok;
+	FILE *file;
+	if ((file = fopen(filename, "wb")) == NULL) {
+		return 0;
+	}
+	fwrite(PATTERNS_MAGIC, 1, strlen(PATTERNS_MAGIC), file);
+	write_record_number(file, PATTERNS_VERSION);
+	write_record_number(file, NDISTANCE_PATTERNS);
+	for (p = 0; p < NDISTANCE_PATTERNS; p++) {
+		write_record_number(file, DISTANCE_PATTERN_SIZES[p]);
+	}
+	for (p = 0; p < NDISTANCE_PATTERNS; p++) {
+		fwrite(dist->patterns[p], 1,
+				(DISTANCE_PATTERN_SIZES[p] + 1) / 2, file);
+	}
+	ok = ! ferror(file);
+	return fclose(file) == 0 && ok;
+}
+
+/** Normal vector of each face, pointing outside. */
+const int FACE_NORMALS[NFACES][3] = {
+	{0, 0, 1}, {0, 1, 0}, {-1, 0, 0}, {1, 0, 0}, {0, -1, 0}, {0, 0, -1}
+};
+
+/** Permutation of the stickers for each way to exchange the axes x, y, z and
+ * change their signs, which are the 24 rotations and their 24 mirrors. */
+void init_distance_symmetries(struct rubik_distance_st *dist) {
+	int s, i, a, f, x, y, z, axes[3], coords[NMINICUBES][3];
+	int c[3], n[3], newc[3], newn[3];
+	char positions[3][3][3];
+	i = 0;
+	for (z = 0; z < 3; z++) {
+		for (y = 0; y < 3; y++) {
+			for (x = 0; x < 3; x++) {
+				if (count_minicube_colors(x, y, z) > 1) {
+					coords[i][0] = x;
+					coords[i][1] = y;
+					coords[i][2] = z;
+					positions[x][y][z] = i++;
+				}
+			}
+		}
+	}
+	for (s = 0; s < NSYMMETRIES; s++) {
+		axes[0] = s / 16;
+		axes[1] = (axes[0] + 1 + s / 8 % 2) % 3;
+		axes[2] = 3 - axes[0] - axes[1];
+		for (i = 0; i < NSTICKERS; i++) {
+			for (a = 0; a < 3; a++) {
+				c[a] = coords[(int) CUBE_FACES_INDEXES[i][0]][a] - 1;
+				n[a] = FACE_NORMALS[(int) CUBE_FACES_INDEXES[i][1]][a];
+			}
+			for (a = 0; a < 3; a++) {
+				newc[a] = (s >> a & 1 ? -1 : 1) * c[axes[a]] + 1;
+				newn[a] = (s >> a & 1 ? -1 : 1) * n[axes[a]];
+			}
+			for (f = 0; memcmp(FACE_NORMALS[f], newn, sizeof(newn));
+					f++)
+				;
+			dist->symmetries[s][i] = STICKER_INDEXES[(int) positions
+				[newc[0]][newc[1]][newc[2]]][f];
+		}
+	}
+}
+
+/** Reduces the stickers of a position to the minor of its 48 symmetries. */
+void canonical_distance_stickers(struct rubik_distance_st *dist,
+		char stickers[NSTICKERS], char canonical[NSTICKERS]) {
+	int s, i;
+	char *sym, symmetric[NSTICKERS];
+	memcpy(canonical, stickers, NSTICKERS);
+	for (s = 1; s < NSYMMETRIES; s++) {
+		sym = dist->symmetries[s];
+		for (i = 0; i < NSTICKERS; i++) {
+			symmetric[(int) sym[i]] = sym[(int) stickers[i]];
+		}
+		if (memcmp(symmetric, canonical, NSTICKERS) < 0) {
+			memcpy(canonical, symmetric, NSTICKERS);
+		}
+	}
+}
+
+/** Entry of the cache for the position, reduced by its symmetries to the
+ * given canonical stickers, with the bounds 0 and 20 if it was not there. */
+struct rubik_distance_cache_st *find_distance_cache(
+		struct rubik_distance_st *dist,
+		char currentorients[NMINICUBES],
+		char minicubesbypos[NMINICUBES], char canonical[NSTICKERS]) {
+	int i;
+	unsigned long hash = 0;
+	char stickers[NSTICKERS];
+	struct rubik_distance_cache_st *entry;
+	cube_point_to_stickers(currentorients, minicubesbypos, stickers);
+	canonical_distance_stickers(dist, stickers, canonical);
+	for (i = 0; i < NSTICKERS; i++) {
+		hash = hash * 31 + canonical[i];
+	}
+	entry = &dist->cache[hash % DISTANCE_CACHE_SIZE];
+	if (! entry->used || memcmp(entry->stickers, canonical, NSTICKERS)) {
+		memcpy(entry->stickers, canonical, NSTICKERS);
+		entry->lower = 0;
+		entry->upper = MAX_DISTANCE;
+		entry->used = 1;
+	}
+	return entry;
+}
+
+/** Joins the new bounds with the ones of the entry, which is replaced when
+ * another position took it in the meantime. */
+void update_distance_cache(struct rubik_distance_cache_st *entry,
+		char canonical[NSTICKERS], int lower, int upper) {
+	if (memcmp(entry->stickers, canonical, NSTICKERS)) {
+		memcpy(entry->stickers, canonical, NSTICKERS);
+		entry->lower = 0;
+		entry->upper = MAX_DISTANCE;
+	}
+	if (lower > entry->lower) {
+		entry->lower = lower;
+	}
+	if (upper < entry->upper) {
+		entry->upper = upper;
+	}
+}
+
+void free_distance(struct rubik_distance_st *dist) {
+	int c, p;
+	for (c = 0; c < NDISTANCE_COORDS; c++) {
+		free(dist->coordmoves[c]);
+	}
+	for (p = 0; p < NDISTANCE_PATTERNS; p++) {
+		free(dist->patterns[p]);
+	}
+	free(dist->cache);
+}
+
+/** Saves in result the cubies seen from the given axis, 0 for U-D, 1 for
+ * R-L and 2 for F-B, rotating them around the corners URF and DBL. */
+void rotate_distance_cubies(const struct rubik_cubies_st *cubies, int axis,
+		struct rubik_cubies_st *result) {
+	int i;
+	struct rubik_cubies_st rotated;
+	*result = *cubies;
+	for (i = 0; i < axis; i++) {
+		multiply_cubies(&URF_ROTATION, result, &rotated);
+		multiply_cubies(&rotated, &URF_ROTATION, result);
+		multiply_cubies(result, &URF_ROTATION, &rotated);
+		*result = rotated;
+	}
+}
+
+/** Saves the cubies of each move and the move seen from each axis, that
+ * turns the rotated cubies like the move turns the original ones. */
+void init_distance_moves(struct rubik_distance_st *dist) {
+	int m, n, a;
+	char currentorients[NMINICUBES], minicubesbypos[NMINICUBES];
+	struct rubik_cubies_st rotated;
+	for (m = 0; m < NDISTANCE_MOVES; m++) {
+		memset(currentorients, 0, NMINICUBES);
+		init_minicubes_by_position(currentorients, minicubesbypos);
+		rotate_cube_face(m / 3, DISTANCE_MOVE_TIMES[m % 3],
+				currentorients, minicubesbypos);
+		cube_point_to_cubies(currentorients, minicubesbypos,
+				&dist->movecubies[m]);
+	}
+	for (a = 0; a < NDISTANCE_AXES; a++) {
+		for (m = 0; m < NDISTANCE_MOVES; m++) {
+			rotate_distance_cubies(&dist->movecubies[m], a,
+					&rotated);
+			dist->axismoves[a][m] = -1;
+			for (n = 0; n < NDISTANCE_MOVES; n++) {
+				if (! memcmp(&dist->movecubies[n], &rotated,
+							sizeof(rotated))) {
+					dist->axismoves[a][m] = n;
+				}
+			}
+		}
+	}
+}
+
+/** Prepares the moves, the tables of moves of the coordinates, the
+ * symmetries, the cache and the memory of the patterns, whose distances are
+ * calculated or loaded after, returning false if there is not enough
+ * memory. */
+char init_distance(struct rubik_distance_st *dist) {
+	int c, p;
+	char allocated = 1;
+	for (c = 0; c < NDISTANCE_COORDS; c++) {
+		dist->coordmoves[c] = malloc(DISTANCE_COORD_SIZES[c]
+				* NDISTANCE_MOVES * sizeof(unsigned short));
+		allocated = allocated && dist->coordmoves[c] != NULL;
+	}
+	for (p = 0; p < NDISTANCE_PATTERNS; p++) {
+		dist->patterns[p] = malloc((DISTANCE_PATTERN_SIZES[p] + 1) / 2);
+		allocated = allocated && dist->patterns[p] != NULL;
+	}
+	dist->cache = malloc(DISTANCE_CACHE_SIZE * sizeof(*dist->cache));
+	if (! allocated || dist->cache == NULL) {
+		free_distance(dist);
+		return 0;
+	}
+	memset(dist->cache, 0, DISTANCE_CACHE_SIZE * sizeof(*dist->cache));
+	init_distance_moves(dist);
+	for (c = 0; c < NDISTANCE_COORDS; c++) {
+		if (! init_distance_coord_moves(dist, c)) {
+			free_distance(dist);
+			return 0;
+		}
+	}
+	init_distance_symmetries(dist);
+	return 1;
+}
+
+/** Returns true when the deadline has passed, checking the clock only every
+ * some nodes. */
+char count_distance_node(struct rubik_distance_st *dist) {
+	if (++dist->nodes % DISTANCE_CLOCK_NODES == 0
+	&& clock() >= dist->deadline) {
+		dist->timeout = 1;
+	}
+	return dist->timeout;
+}
+
+/** Coordinates of the position from each axis, only the coordinates used
+ * by the patterns of the whole cube. */
+void init_axes_coords(const struct rubik_cubies_st *cubies,
+		long coords[NDISTANCE_AXES][NDISTANCE_COORDS]) {
+	int a, c;
+	struct rubik_cubies_st rotated;
+	for (a = 0; a < NDISTANCE_AXES; a++) {
+		rotate_distance_cubies(cubies, a, &rotated);
+		for (c = 0; c < UD_EDGES_COORD; c++) {
+			coords[a][c] = cubies_coordinate(c, &rotated);
+		}
+	}
+}
+
+/** Greatest distance of the patterns of the whole cube from all the axes,
+ * 0 only for the solved cube. */
+int distance_lower_bound(struct rubik_distance_st *dist,
+		long coords[NDISTANCE_AXES][NDISTANCE_COORDS]) {
+	int a, d, lower = 0;
+	for (a = 0; a < NDISTANCE_AXES; a++) {
+		d = get_distance_pattern(dist->patterns[CORNERS_PATTERN],
+			distance_pattern_index(CORNERS_PATTERN, coords[a]));
+		lower = d > lower ? d : lower;
+		d = get_distance_pattern(dist->patterns[EDGES_PATTERN],
+			distance_pattern_index(EDGES_PATTERN, coords[a]));
+		lower = d > lower ? d : lower;
+		d = get_distance_pattern(dist->patterns[TWIST_SLICE_PATTERN],
+			distance_pattern_index(TWIST_SLICE_PATTERN, coords[a]));
+		lower = d > lower ? d : lower;
+	}
+	return lower;
+}
+
+/** Returns true if the position of the coordinates is solved with the given
+ * number of moves or less, saving its moves in the path from the depth. */
+char search_distance(struct rubik_distance_st *dist,
+		long coords[NDISTANCE_AXES][NDISTANCE_COORDS], int moves,
+		int depth, int lastface) {
+	int m, a, c, n, lower;
+	long moved[NDISTANCE_AXES][NDISTANCE_COORDS];
+	lower = distance_lower_bound(dist, coords);
+	if (lower == 0) {
+		dist->nsolution = depth;
+		memcpy(dist->solution, dist->path, depth);
+		return 1;
+	}
+	if (lower > moves || count_distance_node(dist)) {
+		return 0;
+	}
+	for (m = 0; m < NDISTANCE_MOVES && ! dist->timeout; m++) {
+		if (is_redundant_distance_move(m, lastface)) {
+			continue;
+		}
+		for (a = 0; a < NDISTANCE_AXES; a++) {
+			n = dist->axismoves[a][m];
+			for (c = 0; c < UD_EDGES_COORD; c++) {
+				moved[a][c] = dist->coordmoves[c][coords[a][c]
+					* NDISTANCE_MOVES + n];
+			}
+		}
+		dist->path[depth] = m;
+		if (search_distance(dist, moved, moves - 1, depth + 1, m / 3)) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/** Greatest distance of the patterns of G1 of the coordinates. */
+int g1_distance_lower_bound(struct rubik_distance_st *dist,
+		long coords[NDISTANCE_COORDS]) {
+	int d1, d2;
+	d1 = get_distance_pattern(dist->patterns[CORNERS_SLICE_PATTERN],
+		distance_pattern_index(CORNERS_SLICE_PATTERN, coords));
+	d2 = get_distance_pattern(dist->patterns[UD_EDGES_SLICE_PATTERN],
+		distance_pattern_index(UD_EDGES_SLICE_PATTERN, coords));
+	return d1 > d2 ? d1 : d2;
+}
+
+/** Returns true if the position of G1 of the coordinates is solved with the
+ * given number of moves or less with the moves of G1, and then the shortest
+ * solution is the path until the depth followed by the moves found. */
+char search_g1_distance(struct rubik_distance_st *dist,
+		long coords[NDISTANCE_COORDS], int moves, int depth,
+		int lastface) {
+	int m, c, lower;
+	long moved[NDISTANCE_COORDS];
+	lower = g1_distance_lower_bound(dist, coords);
+	if (lower == 0) {
+		dist->upper = dist->nsolution = depth;
+		memcpy(dist->solution, dist->path, depth);
+		return 1;
+	}
+	if (lower > moves || count_distance_node(dist)) {
+		return 0;
+	}
+	for (m = 0; m < NDISTANCE_MOVES && ! dist->timeout; m++) {
+		if (! is_g1_distance_move(m)
+		|| is_redundant_distance_move(m, lastface)) {
+			continue;
+		}
+		for (c = SLICE_COORD; c < NDISTANCE_COORDS; c++) {
+			moved[c] = dist->coordmoves[c][coords[c]
+				* NDISTANCE_MOVES + m];
+		}
+		dist->path[depth] = m;
+		if (search_g1_distance(dist, moved, moves - 1, depth + 1,
+					m / 3)) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/** Solves the position reached in G1 after the path until the depth with
+ * less moves than the upper bound, turning the cubies of the position
+ * searched with the path to know the permutations of the corners and of the
+ * 8 edges of U and D, which leave their positions with the moves out of G1. */
+void solve_g1_distance(struct rubik_distance_st *dist,
+		long coords[NDISTANCE_COORDS], int depth) {
+	int i, moves;
+	struct rubik_cubies_st cubies, moved;
+	cubies = dist->root;
+	for (i = 0; i < depth; i++) {
+		multiply_cubies(&cubies, &dist->movecubies[(int) dist->path[i]],
+				&moved);
+		cubies = moved;
+	}
+	coords[CORNERS_COORD] = cubies_coordinate(CORNERS_COORD, &cubies);
+	coords[UD_EDGES_COORD] = cubies_coordinate(UD_EDGES_COORD, &cubies);
+	for (moves = g1_distance_lower_bound(dist, coords);
+			depth + moves < dist->upper && ! dist->timeout;
+			moves++) {
+		if (search_g1_distance(dist, coords, moves, depth,
+			depth > 0 ? dist->path[depth - 1] / 3 : -1)) {
+			break;
+		}
+	}
+}
+
+/** Searches the positions of G1 reached with the given number of moves, and
+ * then their solutions in G1. The first phase does not end with a move of G1,
+ * because without it the same position was reached with one move less, so
+ * in G1 with less than 5 moves left, which cannot leave G1 and return to it
+ * with other moves, those moves are left for the second phase. Returns true
+ * when the upper bound reaches the lower one. */
+char search_two_phase_distance(struct rubik_distance_st *dist,
+		long coords[NDISTANCE_COORDS], int moves, int depth,
+		int lastface) {
+	int m, c, d;
+	long moved[NDISTANCE_COORDS];
+	d = get_distance_pattern(dist->patterns[TWIST_SLICE_PATTERN],
+		distance_pattern_index(TWIST_SLICE_PATTERN, coords));
+	c = get_distance_pattern(dist->patterns[FLIP_SLICE_PATTERN],
+		distance_pattern_index(FLIP_SLICE_PATTERN, coords));
+	d = c > d ? c : d;
+	if (moves == 0) {
+		if (d == 0 && (depth == 0
+		|| ! is_g1_distance_move(dist->path[depth - 1]))) {
+			solve_g1_distance(dist, coords, depth);
+		}
+		return dist->upper <= dist->lower;
+	}
+	if (d > moves || count_distance_node(dist)) {
+		return 0;
+	}
+	for (m = 0; m < NDISTANCE_MOVES && ! dist->timeout; m++) {
+		if (is_redundant_distance_move(m, lastface)
+		|| (d == 0 && moves < 5 && is_g1_distance_move(m))) {
+			continue;
+		}
+		for (c = 0; c < CORNERS_COORD; c++) {
+			moved[c] = dist->coordmoves[c][coords[c]
+				* NDISTANCE_MOVES + m];
+		}
+		dist->path[depth] = m;
+		if (search_two_phase_distance(dist, moved, moves - 1,
+					depth + 1, m / 3)) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/** Finds the lower and upper bounds of the distance of the position to the
+ * solved cube, with the two-phase algorithm during half of the budget and
+ * then searching solutions of each length until the budget is spent. The
+ * moves of the upper bound are saved in the solution when it is found. */
+void find_distance_bounds(struct rubik_distance_st *dist,
+		char currentorients[NMINICUBES],
+		char minicubesbypos[NMINICUBES], clock_t budget,
+		int *lower, int *upper) {
+	int moves;
+	long coords[NDISTANCE_AXES][NDISTANCE_COORDS];
+	clock_t start;
+	char canonical[NSTICKERS];
+	struct rubik_distance_cache_st *entry;
+	entry = find_distance_cache(dist, currentorients, minicubesbypos,
+			canonical);
+	cube_point_to_cubies(currentorients, minicubesbypos, &dist->root);
+	init_axes_coords(&dist->root, coords);
+	dist->lower = distance_lower_bound(dist, coords);
+	if (entry->lower > dist->lower) {
+		dist->lower = entry->lower;
+	}
+	dist->upper = entry->upper;
+	dist->nsolution = -1;
+	start = clock();
+	dist->deadline = start + budget / 2;
+	dist->timeout = 0;
+	for (moves = 0; moves < dist->upper && dist->lower < dist->upper
+			&& ! dist->timeout; moves++) {
+		search_two_phase_distance(dist, coords[0], moves, 0, -1);
+	}
+	dist->deadline = start + budget;
+	dist->timeout = 0;
+	for (moves = dist->lower; moves < dist->upper && ! dist->timeout;
+			moves++) {
+		if (search_distance(dist, coords, moves, 0, -1)) {
+			dist->upper = moves;
+		} else if (! dist->timeout) {
+			dist->lower = moves + 1;
+		}
+	}
+	if (dist->lower > dist->upper) {
+		dist->lower = dist->upper;
+	}
+	*lower = dist->lower;
+	*upper = dist->upper;
+	update_distance_cache(entry, canonical, *lower, *upper);
+}
+
+/** Prints the lower and upper bounds of the distance of each position of the
+ * file, or an empty line if the line is not valid, returning false if any
+ * line was not valid. */
+char print_distance_bounds(struct rubik_distance_st *dist, FILE *file,
+		clock_t budget) {
+	int valid, lower, upper;
+	unsigned long nline;
+	char line[FACELETS_LINE_SIZE], allvalid;
+	char currentorients[NMINICUBES], minicubesbypos[NMINICUBES];
+	allvalid = 1;
+	for (nline = 1; (valid = read_line(file, line, sizeof(line))) != EOF;
+			nline++) {
+		if (valid && valid_cube_point_chars(line)
+		&& init_cube_point(currentorients, minicubesbypos, line)) {
+			find_distance_bounds(dist, currentorients,
+				minicubesbypos, budget, &lower, &upper);
+			printf("%d %d\n", lower, upper);
+		} else {
+			putchar('\n');
+			fprintf(stderr, "Invalid position in line %lu\n", nline);
+			allvalid = 0;
+		}
+	}
+	return allvalid;
+}
+
+#ifdef INIT_TABLES
+/** Calculates the tables in order, each one requires the previous ones. */
+void init_tables() {
+	init_original_minicube_colors(ORIGCOLORS);
+	init_minicube_orientations(ORIENTATIONS);
+	init_positions_by_mask(POSITIONS_BY_MASK);
+	init_orientations_by_faces(ORIENTS_BY_FACES);
+	init_positions_by_orientation(POSITIONS_BY_ORIENT);
+	init_minicube_transformations(TRANSFORMATIONS);
+	init_facelets(FACELET_POSITIONS, FACELET_FACES, POSITION_FACELETS,
+			FACELET_ORIENTS);
+	init_sticker_indexes(STICKER_INDEXES);
+}
+#endif
+
+void print_table_indent(int depth) {
+	while (depth-- > 0) {
+		putchar('\t');
+	}
+}
+
+/** Prints the values of a table of the given dimensions between braces,
+ * the tables of one dimension in lines of 16 values. */
+void print_table_values(const char *values, int *dims, int ndims, int depth) {
+	int i, size = 1;
+	for (i = 1; i < ndims; i++) {
+		size *= dims[i];
+	}
+	if (ndims == 1 && depth > 0) {
+		putchar('{');
+		for (i = 0; i < dims[0]; i++) {
+			printf(i > 0 ? ", %d" : "%d", values[i]);
+		}
+		putchar('}');
+		return;
+	}
+	printf("{\n");
+	for (i = 0; i < dims[0]; i++) {
+		if (ndims > 1) {
+			print_table_indent(depth + 1);
+			print_table_values(values + i * size, dims + 1,
+					ndims - 1, depth + 1);
+		} else {
+			if (i % 16 == 0) {
+				print_table_indent(depth + 1);
+			}
+			printf("%d", values[i]);
+		}
+		if (i + 1 < dims[0]) {
+			putchar(',');
+			putchar(ndims > 1 || i % 16 == 15 ? '\n' : ' ');
+		}
+	}
+	putchar('\n');
+	print_table_indent(depth);
+	putchar('}');
+}
+
+/** Prints the definition in C of a table of up to 3 dimensions. */
+void print_table(char *name, char *dimnames, const char *values, int ndims,
+		int dim0, int dim1, int dim2) {
+	int dims[3];
+	dims[0] = dim0;
+	dims[1] = dim1;
+	dims[2] = dim2;
+	printf("static const char %s%s = ", name, dimnames);
+	print_table_values(values, dims, ndims, 0);
+	printf(";\n");
+}
+
+/** Prints the tables calculated by the init functions to include them in the
+ * program as read-only data instead of calculating them when it starts. */
+void print_tables() {
+	printf("/* Tables of rubik.c generated with: rubik --tables */\n");
+	print_table("ORIGCOLORS", "[NMINICUBES][NFACES]", ORIGCOLORS[0],
+			2, NMINICUBES, NFACES, 0);
+	print_table("ORIENTATIONS", "[NORIENTS][NFACES]", ORIENTATIONS[0],
+			2, NORIENTS, NFACES, 0);
+	print_table("TRANSFORMATIONS", "[NROTATIONS][NORIENTS]",
+			TRANSFORMATIONS[0], 2, NROTATIONS, NORIENTS, 0);
+	print_table("POSITIONS_BY_MASK", "[NFACE_MASKS]", POSITIONS_BY_MASK,
+			1, NFACE_MASKS, 0, 0);
+	print_table("ORIENTS_BY_FACES", "[NFACES][NFACES]", ORIENTS_BY_FACES[0],
+			2, NFACES, NFACES, 0);
+	print_table("POSITIONS_BY_ORIENT", "[NMINICUBES][NORIENTS]",
+			POSITIONS_BY_ORIENT[0], 2, NMINICUBES, NORIENTS, 0);
+	print_table("FACELET_POSITIONS", "[NFACELETS]", FACELET_POSITIONS,
+			1, NFACELETS, 0, 0);
+	print_table("FACELET_FACES", "[NFACELETS]", FACELET_FACES,
+			1, NFACELETS, 0, 0);
+	print_table("POSITION_FACELETS", "[NMINICUBES][NFACES]",
+			POSITION_FACELETS[0], 2, NMINICUBES, NFACES, 0);
+	print_table("FACELET_ORIENTS", "[NMINICUBES][NFACES][NFACES]",
+			FACELET_ORIENTS[0][0], 3, NMINICUBES, NFACES, NFACES);
+	print_table("STICKER_INDEXES", "[NMINICUBES][NFACES]",
+			STICKER_INDEXES[0], 2, NMINICUBES, NFACES, 0);
+}
+
+/* Remove #define NDEBUG to enable the tests, and define also TEST_DISTANCE to
+enable the slower ones of the distances. */
+#define NDEBUG
+
+#ifndef NDEBUG
+
+#include <assert.h>
+#define MAX_ITEST_RESULTS 5
 
 struct rubik_input_test_st {
 	char *instr;
@@ -848,23 +3705,720 @@ void test_process_input_char() {
 	check_input_test_results(&itest);
 }
 
+void check_simplify_test_results(struct rubik_input_test_st *itest) {
+	char c;
+	int i, r, n, ncalls, nmoves;
+	struct rubik_move_st moves[MAX_ITEST_RESULTS * 4];
+	printf("TEST: %s", itest->instr);
+	init_input_state();
+	nmoves = 0;
+	for (i = 0; (c = itest->instr[i]) != '\0'; i++) {
+		ncalls = (c == '\n' ? 2 : 1);
+		for (n = 0; n < ncalls; n++) {
+			if (process_input_char(c)) {
+				assert(nmoves < MAX_ITEST_RESULTS * 4);
+				moves[nmoves++] = ST.result;
+			}
+		}
+	}
+	nmoves = simplify_moves(moves, nmoves);
+	assert(nmoves == itest->nresults);
+	for (r = 0; r < nmoves; r++) {
+		assert(moves[r].face == itest->results[r].face);
+		assert(moves[r].times == itest->results[r].times);
+	}
+}
+
+void test_simplify_moves() {
+	struct rubik_input_test_st itest;
+	init_input_test(&itest, "1 6 1'\n");
+	add_input_test_result(&itest, '6', 1);
+	check_simplify_test_results(&itest);
+
+	init_input_test(&itest, "6 1\n");
+	add_input_test_result(&itest, '1', 1);
+	add_input_test_result(&itest, '6', 1);
+	check_simplify_test_results(&itest);
+
+	init_input_test(&itest, "2 1 6 1' 6 2'\n");
+	add_input_test_result(&itest, '2', 1);
+	add_input_test_result(&itest, '6', 2);
+	add_input_test_result(&itest, '2', -1);
+	check_simplify_test_results(&itest);
+
+	init_input_test(&itest, "2 1 6 1' 6' 2'\n");
+	check_simplify_test_results(&itest);
+
+	init_input_test(&itest, "3 4 3' 4\" 2 5 2' 5'\n");
+	add_input_test_result(&itest, '4', -1);
+	check_simplify_test_results(&itest);
+
+	init_input_test(&itest, "1'1'1 2 2\n");
+	add_input_test_result(&itest, '1', -1);
+	add_input_test_result(&itest, '2', 2);
+	check_simplify_test_results(&itest);
+}
+
+void add_history_test_move(struct rubik_history_st *hist,
+		char facechar, int times) {
+	struct rubik_move_st move;
+	move.face = char_to_color(facechar);
+	move.times = times;
+	assert(add_history_move(hist, &move));
+}
+
+void check_history_test_move(struct rubik_history_st *hist,
+		char facechar, int times) {
+	struct rubik_move_st move;
+	assert(next_history_move(hist, &move));
+	assert(move.face == char_to_color(facechar));
+	assert(move.times == times);
+}
+
+void test_history() {
+	struct rubik_history_st hist;
+	printf("TEST: history\n");
+	assert(init_history(&hist));
+	assert(! undo_history(&hist));
+	assert(! redo_history(&hist));
+	add_history_test_move(&hist, '1', 1);
+	mark_history_branch(&hist, 'a');
+	add_history_test_move(&hist, '2', -1);
+	add_history_test_move(&hist, '3', 2);
+	mark_history_branch(&hist, 'b');
+	assert(undo_history(&hist));
+	check_history_test_move(&hist, '3', 2);
+	assert(! next_history_move(&hist, NULL));
+	assert(undo_history(&hist));
+	check_history_test_move(&hist, '2', 1);
+	assert(redo_history(&hist));
+	check_history_test_move(&hist, '2', -1);
+	assert(undo_history(&hist));
+	check_history_test_move(&hist, '2', 1);
+	add_history_test_move(&hist, '4', 1);
+	assert(! redo_history(&hist));
+	assert(goto_history_branch(&hist, 'b'));
+	check_history_test_move(&hist, '4', -1);
+	check_history_test_move(&hist, '2', -1);
+	check_history_test_move(&hist, '3', 2);
+	assert(! next_history_move(&hist, NULL));
+	assert(goto_history_branch(&hist, 'a'));
+	check_history_test_move(&hist, '3', 2);
+	check_history_test_move(&hist, '2', 1);
+	assert(! next_history_move(&hist, NULL));
+	assert(redo_history(&hist));
+	check_history_test_move(&hist, '2', -1);
+	assert(! goto_history_branch(&hist, 'c'));
+	free_history(&hist);
+}
+
+/** Checks that the tables included are the same calculated by the init
+ * functions, each one using the previous tables already checked. */
+void test_tables() {
+	char origcolors[NMINICUBES][NFACES], orientations[NORIENTS][NFACES];
+	char transformations[NROTATIONS][NORIENTS];
+	char positionsbymask[NFACE_MASKS], orientsbyfaces[NFACES][NFACES];
+	char positionsbyorient[NMINICUBES][NORIENTS];
+	char faceletpositions[NFACELETS], faceletfaces[NFACELETS];
+	char positionfacelets[NMINICUBES][NFACES];
+	char faceletorients[NMINICUBES][NFACES][NFACES];
+	char stickerindexes[NMINICUBES][NFACES];
+	printf("TEST: tables\n");
+	init_original_minicube_colors(origcolors);
+	assert(! memcmp(origcolors, ORIGCOLORS, sizeof(origcolors)));
+	init_minicube_orientations(orientations);
+	assert(! memcmp(orientations, ORIENTATIONS, sizeof(orientations)));
+	init_positions_by_mask(positionsbymask);
+	assert(! memcmp(positionsbymask, POSITIONS_BY_MASK,
+				sizeof(positionsbymask)));
+	init_orientations_by_faces(orientsbyfaces);
+	assert(! memcmp(orientsbyfaces, ORIENTS_BY_FACES,
+				sizeof(orientsbyfaces)));
+	init_positions_by_orientation(positionsbyorient);
+	assert(! memcmp(positionsbyorient, POSITIONS_BY_ORIENT,
+				sizeof(positionsbyorient)));
+	init_minicube_transformations(transformations);
+	assert(! memcmp(transformations, TRANSFORMATIONS,
+				sizeof(transformations)));
+	init_facelets(faceletpositions, faceletfaces, positionfacelets,
+			faceletorients);
+	assert(! memcmp(faceletpositions, FACELET_POSITIONS,
+				sizeof(faceletpositions)));
+	assert(! memcmp(faceletfaces, FACELET_FACES, sizeof(faceletfaces)));
+	assert(! memcmp(positionfacelets, POSITION_FACELETS,
+				sizeof(positionfacelets)));
+	assert(! memcmp(faceletorients, FACELET_ORIENTS,
+				sizeof(faceletorients)));
+	init_sticker_indexes(stickerindexes);
+	assert(! memcmp(stickerindexes, STICKER_INDEXES,
+				sizeof(stickerindexes)));
+}
+
+/** Checks that the statistics updated with each rotation are the same as
+ * counting all the minicubes again. */
+void test_cube_stats() {
+	int i;
+	char currentorients[NMINICUBES], minicubesbypos[NMINICUBES];
+	char *moves = "1\"43'5261'3\"2\n\n";
+	struct rubik_cube_stats_st stats, counted;
+	printf("TEST: cube stats\n");
+	assert(init_cube_point(currentorients, minicubesbypos,
+				"AAAAAAAAAAAAAAAAAAAA"));
+	init_cube_stats(&stats, currentorients, minicubesbypos);
+	assert(stats.nsolved == NMINICUBES && stats.nplaced == NMINICUBES);
+	assert(stats.nsolvedfaces == NFACES);
+	init_input_state();
+	for (i = 0; moves[i] != '\0'; i++) {
+		if (process_input_char(moves[i])) {
+			rotate_tracked_cube_face(ST.result.face,
+					ST.result.times, currentorients,
+					minicubesbypos, &stats);
+			init_cube_stats(&counted, currentorients,
+					minicubesbypos);
+			assert(! memcmp(&stats, &counted, sizeof(stats)));
+		}
+	}
+	assert(stats.nsolved < NMINICUBES && stats.nsolvedfaces < NFACES);
+	rotate_tracked_cube_face(0, 1, currentorients, minicubesbypos, &stats);
+	rotate_tracked_cube_face(0, -1, currentorients, minicubesbypos, &stats);
+	assert(! memcmp(&stats, &counted, sizeof(stats)));
+}
+
+/** Facelets URFDLB after turning each face 1-6 once from the solved cube. */
+const char *FACELETS_TEST_MOVES[NFACES] = {
+	"UUUUUUUUUBBBRRRRRRRRRFFFFFFDDDDDDDDDFFFLLLLLLLLLBBBBBB",
+	"UUUUUULLLURRURRURRFFFFFFFFFRRRDDDDDDLLDLLDLLDBBBBBBBBB",
+	"BUUBUUBUURRRRRRRRRUFFUFFUFFFDDFDDFDDLLLLLLLLLBBDBBDBBD",
+	"UUFUUFUUFRRRRRRRRRFFDFFDFFDDDBDDBDDBLLLLLLLLLUBBUBBUBB",
+	"RRRUUUUUURRDRRDRRDFFFFFFFFFDDDDDDLLLULLULLULLBBBBBBBBB",
+	"UUUUUUUUURRRRRRFFFFFFFFFLLLDDDDDDDDDLLLLLLBBBBBBBBBRRR"
+};
+
+/** Checks the facelets of each face turned and that the facelets of some
+ * scrambled positions are converted back to the same positions. */
+void test_facelets() {
+	int f, i;
+	char currentorients[NMINICUBES], minicubesbypos[NMINICUBES];
+	char convertedorients[NMINICUBES], facelets[NFACELETS + 2];
+	char *moves = "1\"43'5261'3\"2\n\n";
+	printf("TEST: facelets\n");
+	for (f = 0; f < NFACES; f++) {
+		assert(init_cube_point(currentorients, minicubesbypos,
+					"AAAAAAAAAAAAAAAAAAAA"));
+		rotate_cube_face(f, 1, currentorients, minicubesbypos);
+		cube_point_to_facelets(currentorients, minicubesbypos,
+				facelets);
+		assert(! memcmp(facelets, FACELETS_TEST_MOVES[f], NFACELETS));
+		assert(facelets_to_cube_point(facelets, convertedorients));
+		assert(! memcmp(convertedorients, currentorients, NMINICUBES));
+	}
+	init_input_state();
+	for (i = 0; moves[i] != '\0'; i++) {
+		if (process_input_char(moves[i])) {
+			rotate_cube_face(ST.result.face, ST.result.times,
+					currentorients, minicubesbypos);
+			cube_point_to_facelets(currentorients, minicubesbypos,
+					facelets);
+			assert(facelets_to_cube_point(facelets,
+						convertedorients));
+			assert(! memcmp(convertedorients, currentorients,
+						NMINICUBES));
+		}
+	}
+	facelets[NFACELETS_PER_FACE / 2] = facelets[NFACELETS_PER_FACE * 3 / 2];
+	assert(! facelets_to_cube_point(facelets, convertedorients));
+}
+
+/** Checks that the order of the group generated by the moves is the given. */
+void check_group_test_order(struct rubik_group_st *group, char *generators,
+		char *order) {
+	char moves[64], calculated[NSTICKERS * 2 + 1];
+	memcpy(moves, generators, strlen(generators) + 1);
+	assert(init_group_moves(group, moves));
+	group_order(group, calculated);
+	assert(! strcmp(calculated, order));
+}
+
+/** Checks the order of some known groups and the membership of positions. */
+void test_group() {
+	static struct rubik_group_st group;
+	char stickers[NSTICKERS];
+	printf("TEST: group\n");
+	check_group_test_order(&group, "1,2,3,4,5,6", "43252003274489856000");
+	check_group_test_order(&group, "1\",2\"", "12");
+	check_group_test_order(&group, "1\",2\",3\",4\",5\",6\"", "663552");
+	check_group_test_order(&group, "1,4", "73483200");
+	moves_to_stickers("14'1\"41'4\"", stickers);
+	assert(sift_group_stickers(&group, 0, stickers) == NSTICKERS);
+	moves_to_stickers("142", stickers);
+	assert(sift_group_stickers(&group, 0, stickers) != NSTICKERS);
+}
+
+/** Returns true if both big cubes of the same size show the same stickers. */
+char same_big_cubes(struct rubik_big_cube_st *a, struct rubik_big_cube_st *b) {
+	int face, row, col;
+	for (face = 0; face < NFACES; face++) {
+		for (row = 0; row < a->size; row++) {
+			for (col = 0; col < a->size; col++) {
+				if (get_big_sticker(a, face, row, col)
+				!= get_big_sticker(b, face, row, col)) {
+					return 0;
+				}
+			}
+		}
+	}
+	return 1;
+}
+
+/** Turns all the layers of the solved big cube in a fixed order, so that no
+ * strip has all its stickers of the same color. */
+void scramble_big_test_cube(struct rubik_big_cube_st *cube) {
+	int m;
+	reset_big_cube(cube);
+	for (m = 0; m < 6 * cube->size; m++) {
+		turn_big_cube_layer(cube, (char) ((m * 5 + m / 7) % NFACES),
+				m % cube->size, m % 3 + 1);
+	}
+}
+
+/** Checks on scrambled cubes of sizes 4 to 6 that turning any layer is the
+ * same as turning the layer of the opposite face at the same place in
+ * reverse, that the reverse turn undoes it and that 4 quarter turns of any
+ * layer leave the cube unchanged. */
+void test_big_cube() {
+	struct rubik_big_cube_st cube, opposite, start;
+	int size, face, depth, times, n;
+	printf("TEST: big cube\n");
+	for (size = 4; size <= 6; size++) {
+		assert(init_big_cube(&cube, size));
+		assert(init_big_cube(&opposite, size));
+		assert(init_big_cube(&start, size));
+		scramble_big_test_cube(&start);
+		for (face = 0; face < NFACES; face++) {
+			for (depth = 0; depth < size; depth++) {
+				for (times = -1; times <= 2; times++) {
+					if (times == 0) {
+						continue;
+					}
+					scramble_big_test_cube(&cube);
+					scramble_big_test_cube(&opposite);
+					turn_big_cube_layer(&cube, (char) face,
+							depth, times);
+					turn_big_cube_layer(&opposite,
+						OPPOSITES[face],
+						size - 1 - depth, -times);
+					assert(same_big_cubes(&cube,
+								&opposite));
+					assert(! same_big_cubes(&cube, &start));
+					turn_big_cube_layer(&cube, (char) face,
+							depth, -times);
+					assert(same_big_cubes(&cube, &start));
+				}
+				for (n = 0; n < 4; n++) {
+					turn_big_cube_layer(&cube, (char) face,
+							depth, 1);
+				}
+				assert(same_big_cubes(&cube, &start));
+			}
+		}
+		free_big_cube(&cube);
+		free_big_cube(&opposite);
+		free_big_cube(&start);
+	}
+}
+
+#ifdef TEST_DISTANCE
+#define PATTERNS_TEST_FILE "rubik_test.pat"
+#define DISTANCE_TEST_MOVES 10
+#define DISTANCE_TEST_EXACT_MOVES 4
+
+/** Applies to the position the given number of moves of a fixed scramble,
+ * none redundant with the previous one. */
+void scramble_distance_test_cube(char currentorients[NMINICUBES],
+		char minicubesbypos[NMINICUBES], int nmoves) {
+	int i, m, lastface = -1;
+	unsigned long x = 2022;
+	for (i = 0; i < nmoves; ) {
+		x = x * 1103515245UL + 12345UL;
+		m = (int) (x >> 16 & 0x7FFF) % NDISTANCE_MOVES;
+		if (! is_redundant_distance_move(m, lastface)) {
+			rotate_cube_face(m / 3, DISTANCE_MOVE_TIMES[m % 3],
+					currentorients, minicubesbypos);
+			lastface = m / 3;
+			i++;
+		}
+	}
+}
+
+/** Returns true if the position is solved with the given number of moves or
+ * less, trying all of them with the moves of the cube. */
+char solved_distance_test_cube(char currentorients[NMINICUBES],
+		char minicubesbypos[NMINICUBES], int moves, int lastface) {
+	int i, m;
+	char orients[NMINICUBES], bypos[NMINICUBES];
+	for (i = 0; i < NMINICUBES && currentorients[i] == 0; i++)
+		;
+	if (i == NMINICUBES) {
+		return 1;
+	}
+	for (m = 0; m < NDISTANCE_MOVES && moves > 0; m++) {
+		if (is_redundant_distance_move(m, lastface)) {
+			continue;
+		}
+		memcpy(orients, currentorients, NMINICUBES);
+		memcpy(bypos, minicubesbypos, NMINICUBES);
+		rotate_cube_face(m / 3, DISTANCE_MOVE_TIMES[m % 3],
+				orients, bypos);
+		if (solved_distance_test_cube(orients, bypos, moves - 1,
+					m / 3)) {
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/** Checks that the cubies of the solved cube give 0 in all the coordinates,
+ * that the moves of the cube turn the cubies like their multiplication, that
+ * each move seen from another axis is another move, that the patterns reach
+ * all their indexes, all the corners in 11 moves, and that the distances
+ * loaded from a file are the saved ones. */
+void test_distance_patterns(struct rubik_distance_st *dist) {
+	int a, c, m, p, maxcorners;
+	long i;
+	char currentorients[NMINICUBES], minicubesbypos[NMINICUBES];
+	FILE *file;
+	struct rubik_cubies_st cubies, moved, turned;
+	struct rubik_distance_st loaded;
+	printf("TEST: distance patterns\n");
+	init_solved_cubies(&cubies);
+	for (c = 0; c < NDISTANCE_COORDS; c++) {
+		assert(cubies_coordinate(c, &cubies) == 0);
+	}
+	memset(currentorients, 0, NMINICUBES);
+	init_minicubes_by_position(currentorients, minicubesbypos);
+	for (i = 0; i < 50; i++) {
+		m = (int) (i * 7 % NDISTANCE_MOVES);
+		rotate_cube_face(m / 3, DISTANCE_MOVE_TIMES[m % 3],
+				currentorients, minicubesbypos);
+		multiply_cubies(&cubies, &dist->movecubies[m], &moved);
+		cube_point_to_cubies(currentorients, minicubesbypos, &turned);
+		assert(! memcmp(&moved, &turned, sizeof(moved)));
+		cubies = moved;
+	}
+	for (a = 0; a < NDISTANCE_AXES; a++) {
+		for (m = 0; m < NDISTANCE_MOVES; m++) {
+			assert(dist->axismoves[a][m] != -1);
+			assert(a > 0 || dist->axismoves[a][m] == m);
+		}
+	}
+	init_distance_patterns(dist);
+	for (p = 0; p < NDISTANCE_PATTERNS; p++) {
+		for (i = maxcorners = 0; i < DISTANCE_PATTERN_SIZES[p]; i++) {
+			c = get_distance_pattern(dist->patterns[p], i);
+			assert(c != UNKNOWN_DISTANCE);
+			if (p == CORNERS_PATTERN && c > maxcorners) {
+				maxcorners = c;
+			}
+		}
+		assert(p != CORNERS_PATTERN || maxcorners == 11);
+	}
+	assert(init_distance(&loaded));
+	assert(save_distance_patterns(dist, PATTERNS_TEST_FILE));
+	assert(load_distance_patterns(&loaded, PATTERNS_TEST_FILE));
+	for (p = 0; p < NDISTANCE_PATTERNS; p++) {
+		assert(! memcmp(dist->patterns[p], loaded.patterns[p],
+					(DISTANCE_PATTERN_SIZES[p] + 1) / 2));
+	}
+	assert((file = fopen(PATTERNS_TEST_FILE, "wb")) != NULL);
+	fwrite(PATTERNS_MAGIC, 1, strlen(PATTERNS_MAGIC), file);
+	fclose(file);
+	assert(! load_distance_patterns(&loaded, PATTERNS_TEST_FILE));
+	remove(PATTERNS_TEST_FILE);
+	free_distance(&loaded);
+}
+
+/** Checks on scrambles of up to 10 moves that the bounds include the number
+ * of moves, that the moves of the upper bound solve the position, that the
+ * bounds include the exact distance of the shortest ones, found trying all
+ * the moves, and that their symmetric positions have the same canonical
+ * stickers. */
+void test_distance_bounds(struct rubik_distance_st *dist) {
+	int n, d, s, i, lower, upper;
+	char currentorients[NMINICUBES], minicubesbypos[NMINICUBES];
+	char stickers[NSTICKERS], symmetric[NSTICKERS];
+	char canonical[NSTICKERS], symcanonical[NSTICKERS];
+	printf("TEST: distance bounds\n");
+	for (n = 0; n <= DISTANCE_TEST_MOVES; n++) {
+		memset(currentorients, 0, NMINICUBES);
+		init_minicubes_by_position(currentorients, minicubesbypos);
+		scramble_distance_test_cube(currentorients, minicubesbypos, n);
+		find_distance_bounds(dist, currentorients, minicubesbypos,
+				CLOCKS_PER_SEC, &lower, &upper);
+		assert(lower <= upper && upper <= n);
+		if (dist->nsolution == upper) {
+			for (i = 0; i < upper; i++) {
+				rotate_cube_face(dist->solution[i] / 3,
+					DISTANCE_MOVE_TIMES[dist->solution[i]
+					% 3], currentorients, minicubesbypos);
+			}
+			assert(solved_distance_test_cube(currentorients,
+						minicubesbypos, 0, -1));
+			memset(currentorients, 0, NMINICUBES);
+			init_minicubes_by_position(currentorients,
+					minicubesbypos);
+			scramble_distance_test_cube(currentorients,
+					minicubesbypos, n);
+		}
+		if (n <= DISTANCE_TEST_EXACT_MOVES) {
+			for (d = 0; ! solved_distance_test_cube(currentorients,
+					minicubesbypos, d, -1); d++)
+				;
+			assert(lower <= d && d <= upper);
+			assert(lower < upper || d == lower);
+		}
+		cube_point_to_stickers(currentorients, minicubesbypos,
+				stickers);
+		canonical_distance_stickers(dist, stickers, canonical);
+		for (s = 0; s < NSYMMETRIES; s++) {
+			for (i = 0; i < NSTICKERS; i++) {
+				symmetric[(int) dist->symmetries[s][i]] =
+					dist->symmetries[s][(int) stickers[i]];
+			}
+			canonical_distance_stickers(dist, symmetric,
+					symcanonical);
+			assert(! memcmp(canonical, symcanonical, NSTICKERS));
+		}
+	}
+}
+#endif
+
+#define RECORD_TEST_FILE "rubik_test.rec"
+#define RECORD_TEST_MOVES (RECORD_INTERVAL * 2 + 3)
+
+void init_record_test_move(struct rubik_move_st *move, unsigned long m) {
+	move->face = (m * 5 + m / 7) % NFACES;
+	move->times = m % 3 == 0 ? 1 : (m % 3 == 1 ? -1 : 2);
+}
+
+/** Records a sequence checking in the middle that the file being written is
+ * valid with the moves of the completed blocks, and checks that seeking
+ * before, on and after each snapshot gives the same position as replaying
+ * the moves read from the recording, and that seeking past the end fails. */
+void test_record() {
+	unsigned long m;
+	char currentorients[NMINICUBES], minicubesbypos[NMINICUBES];
+	char seekorients[NMINICUBES], seekbypos[NMINICUBES];
+	char blockorients[NMINICUBES];
+	struct rubik_move_st move, read;
+	struct rubik_record_st rec, partial;
+	printf("TEST: record\n");
+	assert(init_cube_point(currentorients, minicubesbypos,
+				"AAAAAAAAAAAAAAAAAAAA"));
+	assert(open_record(&rec, RECORD_TEST_FILE, currentorients));
+	for (m = 0; m < RECORD_TEST_MOVES; m++) {
+		init_record_test_move(&move, m);
+		rotate_cube_face(move.face, move.times,
+				currentorients, minicubesbypos);
+		assert(record_move(&rec, &move, currentorients));
+		if (m + 1 == RECORD_INTERVAL) {
+			memcpy(blockorients, currentorients, NMINICUBES);
+		} else if (m == RECORD_INTERVAL + 1) {
+			assert(open_replay(&partial, RECORD_TEST_FILE));
+			assert(partial.nmoves == RECORD_INTERVAL);
+			assert(seek_replay(&partial, RECORD_INTERVAL,
+						seekorients, seekbypos));
+			assert(! memcmp(seekorients, blockorients,
+						NMINICUBES));
+			fclose(partial.file);
+		}
+	}
+	rec.nmoves = RECORD_MAX_MOVES;
+	assert(! record_move(&rec, &move, currentorients));
+	rec.nmoves = RECORD_TEST_MOVES;
+	assert(close_record(&rec));
+	assert(open_replay(&rec, RECORD_TEST_FILE));
+	assert(rec.nmoves == RECORD_TEST_MOVES && rec.nsnapshots == 3);
+	assert(init_cube_point(currentorients, minicubesbypos,
+				"AAAAAAAAAAAAAAAAAAAA"));
+	for (m = 0; m <= RECORD_TEST_MOVES; m++) {
+		if (m % RECORD_INTERVAL <= 1
+				|| m % RECORD_INTERVAL == RECORD_INTERVAL - 1
+				|| m == RECORD_TEST_MOVES) {
+			assert(seek_replay(&rec, m, seekorients, seekbypos));
+			assert(! memcmp(seekorients, currentorients,
+						NMINICUBES));
+			assert(! memcmp(seekbypos, minicubesbypos,
+						NMINICUBES));
+		}
+		if (m < RECORD_TEST_MOVES) {
+			init_record_test_move(&move, m);
+			assert(read_replay_move(&rec, m, &read));
+			assert(read.face == move.face
+					&& read.times == move.times);
+			rotate_cube_face(read.face, read.times,
+					currentorients, minicubesbypos);
+		}
+	}
+	assert(! seek_replay(&rec, RECORD_TEST_MOVES + 1,
+				seekorients, seekbypos));
+	fclose(rec.file);
+	remove(RECORD_TEST_FILE);
+}
+
 #endif
 
+/** Maximum number of moves of a line simplified before applying them, when a
+ * longer line fills the buffer, its moves are simplified and applied by parts. */
+#define MAX_LINE_MOVES 1024
+
+#define TO_FACELETS 1
+#define FROM_FACELETS 2
+
+#define UNDO_CHAR '<'
+#define REDO_CHAR '>'
+#define MARK_CHAR '!'
+#define GOTO_CHAR '@'
+
+/** Returns false if the colors use the characters of the history commands. */
+char valid_history_color_chars(char *colorchars) {
+	return strchr(colorchars, UNDO_CHAR) == NULL
+		&& strchr(colorchars, REDO_CHAR) == NULL
+		&& strchr(colorchars, MARK_CHAR) == NULL
+		&& strchr(colorchars, GOTO_CHAR) == NULL;
+}
+
+/** Applies the move to the cube updating the statistics if not NULL and
+ * saves it in the recording if not NULL, returning false if it is full. */
+char apply_move(struct rubik_move_st *move, char currentorients[NMINICUBES],
+		char minicubesbypos[NMINICUBES], struct rubik_cube_stats_st *stats,
+		struct rubik_record_st *rec) {
+	if (stats != NULL) {
+		rotate_tracked_cube_face(move->face, move->times,
+				currentorients, minicubesbypos, stats);
+	} else {
+		rotate_cube_face(move->face, move->times,
+				currentorients, minicubesbypos);
+	}
+	return rec == NULL || record_move(rec, move, currentorients);
+}
+
+#define DEPTH_START_CHAR '('
+#define DEPTH_END_CHAR ')'
+
+/** Returns false if the colors use the characters of the depth of layers. */
+char valid_big_color_chars(char *colorchars) {
+	return strchr(colorchars, DEPTH_START_CHAR) == NULL
+		&& strchr(colorchars, DEPTH_END_CHAR) == NULL;
+}
+
+/** Applies the moves of the input to the big cube like with the 3x3x3, but
+ * entering (D) the next moves of the line turn the layer D of the faces. A
+ * group not closed ends at the first character that is not a digit, which is
+ * then applied like any other. */
+void play_big_cube(struct rubik_big_cube_st *cube, char silent) {
+	int c, n, ncalls, depth = 0, newdepth = -1;
+	init_input_state();
+	c = '\n';
+	while (c != EOF) {
+		if (c == DEPTH_START_CHAR) {
+			for (n = 0; n < 2; n++) {
+				if (process_input_char('\n')) {
+					turn_big_cube_layer(cube, ST.result.face,
+						depth, ST.result.times);
+				}
+			}
+			newdepth = 0;
+		} else if (newdepth != -1 && isdigit(c)) {
+			if (newdepth <= cube->size) {
+				newdepth = newdepth * 10 + (c - '0');
+			}
+		} else if (newdepth != -1 && c == DEPTH_END_CHAR) {
+			if (newdepth >= 1 && newdepth <= cube->size) {
+				depth = newdepth - 1;
+			}
+			newdepth = -1;
+		} else {
+			newdepth = -1;
+			ncalls = (c == '\n' ? 2 : 1);
+			for (n = 0; n < ncalls; n++) {
+				if (process_input_char(c)) {
+					turn_big_cube_layer(cube, ST.result.face,
+						depth, ST.result.times);
+				}
+				if (n == 1) {
+					if (! silent) {
+						print_big_cube_net(cube);
+					}
+					print_big_cube_point(cube);
+					depth = 0;
+				}
+			}
+		}
+		c = getchar();
+	}
+}
+
 /*
 #Repeat the sequence of moves 12 to find when the initial position is recovered:
 gcc -ansi -Wall -pedantic -o rubik rubik.c
 yes 12 | head -200 | ./rubik -s | nl | grep AAAAAAAAAAAAAAAAAAAA
 */
 int main(int argc, char *argv[]) {
-	int i, c, ncalls, n;
-	char silent = 0, *initialpoint = "AAAAAAAAAAAAAAAAAAAA";
+	int i, c, ncalls, n, m, nmoves, result = 1;
+	unsigned long seekmoves = 0, nfuzz = 0;
+	unsigned long budget = DEFAULT_DISTANCE_BUDGET;
+	int bigsize = 0;
+	char silent = 0, simplify = 0, *initialpoint = NULL;
+	char history = 0, cmd, pendingcmd = 0, name = '\0', facelets = 0;
+	char tables = 0;
+	char *recordfile = NULL, *replayfile = NULL, *seekarg = NULL;
+	char *exportfile = NULL, *groupgenerators = NULL, *distancefile = NULL;
+	char *patternsfile = NULL;
+	FILE *file;
 	char currentorients[NMINICUBES], minicubesbypos[NMINICUBES];
+	struct rubik_move_st moves[MAX_LINE_MOVES];
+	struct rubik_record_st rec, rep, *recordp = NULL;
+	struct rubik_cube_stats_st stats, *statsp = NULL;
+	struct rubik_history_st hist;
+	struct rubik_move_st move;
+	struct rubik_big_cube_st bigcube;
+	static struct rubik_group_st group;
+	struct rubik_distance_st dist;
+#ifdef INIT_TABLES
+	init_tables();
+#endif
 #ifndef NDEBUG
 	test_process_input_char();
+	test_simplify_moves();
+	test_history();
+	test_record();
+	test_tables();
+	test_facelets();
+	test_group();
+	test_big_cube();
+	test_cube_stats();
+#ifdef TEST_DISTANCE
+	assert(init_distance(&dist));
+	test_distance_patterns(&dist);
+	test_distance_bounds(&dist);
+	free_distance(&dist);
+#endif
 #endif
 	for (i = 1; i < argc; i++) {
 		if (! strcmp(argv[i], "-s") || ! strcmp(argv[i], "--silent")) {
 			silent = 1;
+		} else if (! strcmp(argv[i], "--simplify")) {
+			simplify = 1;
+		} else if (! strcmp(argv[i], "-u") || ! strcmp(argv[i], "--undo")) {
+			history = 1;
+		} else if (! strcmp(argv[i], "--stats")) {
+			statsp = &stats;
+		} else if (! strcmp(argv[i], "--tables")) {
+			tables = 1;
+		} else if (! strcmp(argv[i], "--to-facelets")) {
+			facelets = TO_FACELETS;
+		} else if (! strcmp(argv[i], "--from-facelets")) {
+			facelets = FROM_FACELETS;
 		} else if (i + 1 < argc && (! strcmp(argv[i], "-c")
 					|| ! strcmp(argv[i], "--chars"))) {
 			COLOR_CHARS = argv[++i];
@@ -878,47 +4432,299 @@ int main(int argc, char *argv[]) {
 		} else if (i + 1 < argc && (! strcmp(argv[i], "-i")
 					|| ! strcmp(argv[i], "--initial"))) {
 			initialpoint = argv[++i];
-			if (! valid_cube_point_chars(initialpoint)) {
+		} else if (i + 1 < argc && (! strcmp(argv[i], "-n")
+					|| ! strcmp(argv[i], "--size"))) {
+			bigsize = valid_number_chars(argv[++i])
+				&& strlen(argv[i]) < 6 ? atoi(argv[i]) : 0;
+			if (bigsize < 2 || bigsize > MAX_BIG_CUBE_SIZE) {
+				fprintf(stderr, "Invalid size: %s\n\n",
+					argv[i]);
+				print_help();
+				return -9;
+			}
+		} else if (i + 1 < argc && ! strcmp(argv[i], "--record")) {
+			recordfile = argv[++i];
+		} else if (i + 1 < argc && ! strcmp(argv[i], "--replay")) {
+			replayfile = argv[++i];
+		} else if (i + 1 < argc && ! strcmp(argv[i], "--group")) {
+			groupgenerators = argv[++i];
+		} else if (i + 1 < argc && ! strcmp(argv[i], "--fuzz")) {
+			if (! valid_number_chars(argv[++i])
+			|| (nfuzz = strtoul(argv[i], NULL, 10)) == 0) {
+				fprintf(stderr,
+					"Invalid number of sequences: %s\n\n",
+					argv[i]);
+				print_help();
+				return -10;
+			}
+		} else if (i + 1 < argc
+				&& ! strcmp(argv[i], "--distance-bounds")) {
+			distancefile = argv[++i];
+		} else if (i + 1 < argc && ! strcmp(argv[i], "--patterns")) {
+			patternsfile = argv[++i];
+		} else if (i + 1 < argc && ! strcmp(argv[i], "--budget")) {
+			if (! valid_number_chars(argv[++i])) {
+				fprintf(stderr,
+					"Invalid number of milliseconds: %s\n\n",
+					argv[i]);
+				print_help();
+				return -10;
+			}
+			budget = strtoul(argv[i], NULL, 10);
+			if (budget > LONG_MAX / CLOCKS_PER_SEC * 1000) {
 				fprintf(stderr,
-					"Invalid initial position: %s\n\n",
-					initialpoint);
+					"Too many milliseconds: %s\n\n",
+					argv[i]);
+				print_help();
+				return -10;
+			}
+		} else if (i + 1 < argc && ! strcmp(argv[i], "--export")) {
+			exportfile = argv[++i];
+		} else if (i + 1 < argc && ! strcmp(argv[i], "--seek")) {
+			seekarg = argv[++i];
+			if (! valid_number_chars(seekarg)) {
+				fprintf(stderr, "Invalid move number: %s\n\n",
+					seekarg);
 				print_help();
-				return -2;
+				return -4;
 			}
+			seekmoves = strtoul(seekarg, NULL, 10);
 		} else {
 			print_help();
 			return -1;
 		}
 	}
-	init_original_minicube_colors();
-	init_minicube_orientations();
-	init_minicube_transformations();
+	if (seekarg != NULL && replayfile == NULL) {
+		print_help();
+		return -1;
+	}
+	if (tables) {
+		print_tables();
+		return 1;
+	}
+	if (nfuzz > 0) {
+		return fuzz_engines(nfuzz) ? 1 : -11;
+	}
+	if (bigsize > 0) {
+		if (history || simplify || statsp != NULL || recordfile != NULL
+		|| replayfile != NULL || exportfile != NULL || facelets
+		|| groupgenerators != NULL || distancefile != NULL
+		|| patternsfile != NULL) {
+			fprintf(stderr, "Invalid options with the size %d\n\n",
+				bigsize);
+			print_help();
+			return -9;
+		}
+		if (! valid_big_color_chars(COLOR_CHARS)) {
+			fprintf(stderr, "Invalid color characters: %s\n\n",
+				COLOR_CHARS);
+			print_help();
+			return -3;
+		}
+		if (! init_big_cube(&bigcube, bigsize)) {
+			fprintf(stderr, "Not enough memory for the cube\n");
+			return -7;
+		}
+		if (initialpoint != NULL
+		&& ! read_big_cube_point(&bigcube, initialpoint)) {
+			fprintf(stderr, "Invalid initial position: %s\n\n",
+				initialpoint);
+			free_big_cube(&bigcube);
+			print_help();
+			return -2;
+		}
+		play_big_cube(&bigcube, silent);
+		free_big_cube(&bigcube);
+		return 1;
+	}
+	if (initialpoint == NULL) {
+		initialpoint = "AAAAAAAAAAAAAAAAAAAA";
+	} else if (! valid_cube_point_chars(initialpoint)) {
+		fprintf(stderr, "Invalid initial position: %s\n\n",
+			initialpoint);
+		print_help();
+		return -2;
+	}
+	if (simplify) {
+		history = 0;
+	} else if (history && ! valid_history_color_chars(COLOR_CHARS)) {
+		fprintf(stderr, "Invalid color characters: %s\n\n",
+			COLOR_CHARS);
+		print_help();
+		return -3;
+	}
+	if (facelets) {
+		return convert_facelets_lines(facelets == TO_FACELETS) ? 1 : -8;
+	}
+	if (groupgenerators != NULL) {
+		if (! init_group_moves(&group, groupgenerators)) {
+			fprintf(stderr, "Too many generators: %s\n",
+				groupgenerators);
+			return -7;
+		}
+		print_group_order(&group);
+		return check_group_lines(&group) ? 1 : -8;
+	}
+	if (distancefile != NULL) {
+		if ((file = fopen(distancefile, "r")) == NULL) {
+			fprintf(stderr, "Cannot read the positions: %s\n",
+				distancefile);
+			return -12;
+		}
+		if (! init_distance(&dist)) {
+			fclose(file);
+			fprintf(stderr, "Not enough memory for the distances\n");
+			return -7;
+		}
+		if (patternsfile == NULL
+		|| ! load_distance_patterns(&dist, patternsfile)) {
+			init_distance_patterns(&dist);
+			if (patternsfile != NULL
+			&& ! save_distance_patterns(&dist, patternsfile)) {
+				free_distance(&dist);
+				fclose(file);
+				fprintf(stderr, "Cannot write the patterns: %s\n",
+					patternsfile);
+				return -12;
+			}
+		}
+		i = print_distance_bounds(&dist, file, (clock_t) ((double)
+				budget * CLOCKS_PER_SEC / 1000));
+		free_distance(&dist);
+		fclose(file);
+		return i ? 1 : -8;
+	}
 	if (! init_cube_point(currentorients, minicubesbypos, initialpoint)) {
 		fprintf(stderr, "Invalid initial position: %s\n\n",
 			initialpoint);
 		print_help();
 		return -2;
 	}
+	if (exportfile != NULL) {
+		if (! open_replay(&rep, exportfile) || ! export_replay(&rep)) {
+			fprintf(stderr, "Invalid recording: %s\n", exportfile);
+			return -5;
+		}
+		fclose(rep.file);
+		return 1;
+	}
+	if (replayfile != NULL) {
+		if (! open_replay(&rep, replayfile)
+		|| ! seek_replay(&rep, seekarg != NULL ? seekmoves : rep.nmoves,
+				currentorients, minicubesbypos)) {
+			fprintf(stderr, "Invalid recording or move: %s\n",
+				replayfile);
+			return -5;
+		}
+		fclose(rep.file);
+	}
+	if (statsp != NULL) {
+		init_cube_stats(statsp, currentorients, minicubesbypos);
+	}
+	if (history && ! init_history(&hist)) {
+		fprintf(stderr, "Not enough memory for the history\n");
+		return -7;
+	}
+	if (recordfile != NULL) {
+		if (! open_record(&rec, recordfile, currentorients)) {
+			fprintf(stderr, "Cannot create the recording: %s\n",
+				recordfile);
+			if (history) {
+				free_history(&hist);
+			}
+			return -6;
+		}
+		recordp = &rec;
+	}
 	init_input_state();
-	c = '\n';
-	while (c != EOF) {
-		ncalls = (c == '\n' ? 2 : 1);
+	nmoves = 0;
+	c = simplify ? getchar() : '\n';
+	while (c != EOF && result == 1) {
+		cmd = 0;
+		if (pendingcmd) {
+			if (isgraph(c)) {
+				cmd = pendingcmd;
+				name = c;
+			}
+			pendingcmd = 0;
+		} else if (history && (c == MARK_CHAR || c == GOTO_CHAR)) {
+			pendingcmd = c;
+			c = getchar();
+			continue;
+		} else if (history && (c == UNDO_CHAR || c == REDO_CHAR)) {
+			cmd = c;
+		}
+		ncalls = (c == '\n' || cmd ? 2 : 1);
 		for (n = 0; n < ncalls; n++) {
-			if (process_input_char(c)) {
-				rotate_cube_face(ST.result.face,
-						reduce_times(ST.result.times),
-						currentorients, minicubesbypos);
+			if (process_input_char(cmd ? '\n' : c)) {
+				moves[nmoves++] = ST.result;
+				if (nmoves == MAX_LINE_MOVES) {
+					nmoves = simplify_moves(moves, nmoves);
+				}
+			}
+			if (nmoves == MAX_LINE_MOVES || n == 1) {
+				nmoves = simplify_moves(moves, nmoves);
+				if (simplify) {
+					print_moves(moves, nmoves);
+					putchar(n == 1 ? '\n' : ' ');
+				}
+				for (m = 0; ! simplify && m < nmoves
+						&& result == 1; m++) {
+					if (! apply_move(&moves[m],
+							currentorients,
+							minicubesbypos, statsp,
+							recordp)) {
+						result = -6;
+					} else if (history && ! add_history_move(
+							&hist, &moves[m])) {
+						fprintf(stderr, "Not enough "
+							"memory for the history\n");
+						result = -7;
+					}
+				}
+				nmoves = 0;
 			}
-			if (n == 1) {
+			if (n == 1 && cmd) {
+				if (cmd == UNDO_CHAR) {
+					undo_history(&hist);
+				} else if (cmd == REDO_CHAR) {
+					redo_history(&hist);
+				} else if (cmd == MARK_CHAR) {
+					mark_history_branch(&hist, name);
+				} else {
+					goto_history_branch(&hist, name);
+				}
+				while (result == 1
+				&& next_history_move(&hist, &move)) {
+					if (! apply_move(&move, currentorients,
+						minicubesbypos, statsp,
+						recordp)) {
+						result = -6;
+					}
+				}
+			} else if (n == 1 && ! simplify) {
 				if (! silent) {
 					print_cube_3d(currentorients,
 							minicubesbypos);
 				}
-				print_cube_point(currentorients);
+				if (statsp != NULL) {
+					print_cube_point_stats(currentorients,
+							statsp);
+				} else {
+					print_cube_point(currentorients);
+				}
 			}
 		}
 		c = getchar();
 	}
-	return 1;
+	if (history) {
+		free_history(&hist);
+	}
+	if (recordp != NULL && (! close_record(&rec) || result == -6)) {
+		fprintf(stderr, "Cannot write the recording: %s\n",
+			recordfile);
+		return -6;
+	}
+	return result;
 }
 
@@ -0,0 +1,311 @@
+/* Tables of rubik.c generated with: rubik --tables */
+static const char ORIGCOLORS[NMINICUBES][NFACES] = {
+	{-1, -1, 2, -1, 4, 5},
+	{-1, -1, -1, -1, 4, 5},
+	{-1, -1, -1, 3, 4, 5},
+	{-1, -1, 2, -1, -1, 5},
+	{-1, -1, -1, 3, -1, 5},
+	{-1, 1, 2, -1, -1, 5},
+	{-1, 1, -1, -1, -1, 5},
+	{-1, 1, -1, 3, -1, 5},
+	{-1, -1, 2, -1, 4, -1},
+	{-1, -1, -1, 3, 4, -1},
+	{-1, 1, 2, -1, -1, -1},
+	{-1, 1, -1, 3, -1, -1},
+	{0, -1, 2, -1, 4, -1},
+	{0, -1, -1, -1, 4, -1},
+	{0, -1, -1, 3, 4, -1},
+	{0, -1, 2, -1, -1, -1},
+	{0, -1, -1, 3, -1, -1},
+	{0, 1, 2, -1, -1, -1},
+	{0, 1, -1, -1, -1, -1},
+	{0, 1, -1, 3, -1, -1}
+};
+static const char ORIENTATIONS[NORIENTS][NFACES] = {
+	{0, 1, 2, 3, 4, 5},
+	{0, 2, 4, 1, 3, 5},
+	{0, 4, 3, 2, 1, 5},
+	{0, 3, 1, 4, 2, 5},
+	{1, 0, 3, 2, 5, 4},
+	{1, 3, 5, 0, 2, 4},
+	{1, 5, 2, 3, 0, 4},
+	{1, 2, 0, 5, 3, 4},
+	{2, 0, 1, 4, 5, 3},
+	{2, 1, 5, 0, 4, 3},
+	{2, 5, 4, 1, 0, 3},
+	{2, 4, 0, 5, 1, 3},
+	{3, 0, 4, 1, 5, 2},
+	{3, 4, 5, 0, 1, 2},
+	{3, 5, 1, 4, 0, 2},
+	{3, 1, 0, 5, 4, 2},
+	{4, 0, 2, 3, 5, 1},
+	{4, 2, 5, 0, 3, 1},
+	{4, 5, 3, 2, 0, 1},
+	{4, 3, 0, 5, 2, 1},
+	{5, 1, 3, 2, 4, 0},
+	{5, 3, 4, 1, 2, 0},
+	{5, 4, 2, 3, 1, 0},
+	{5, 2, 1, 4, 3, 0}
+};
+static const char TRANSFORMATIONS[NROTATIONS][NORIENTS] = {
+	{3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14, 19, 16, 17, 18, 23, 20, 21, 22},
+	{9, 17, 13, 5, 12, 21, 10, 1, 4, 20, 18, 2, 16, 22, 6, 0, 8, 23, 14, 3, 15, 19, 11, 7},
+	{16, 12, 4, 8, 20, 9, 0, 15, 23, 17, 1, 7, 21, 5, 3, 19, 22, 13, 2, 11, 18, 10, 6, 14},
+	{6, 10, 18, 14, 2, 13, 22, 11, 3, 5, 21, 19, 1, 17, 23, 7, 0, 9, 20, 15, 4, 12, 16, 8},
+	{15, 7, 11, 19, 8, 3, 14, 23, 16, 0, 6, 22, 4, 2, 18, 20, 12, 1, 10, 21, 9, 5, 13, 17},
+	{1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12, 17, 18, 19, 16, 21, 22, 23, 20}
+};
+static const char POSITIONS_BY_MASK[NFACE_MASKS] = {
+	-1, -1, -1, 18, -1, 15, 10, 17, -1, 16, 11, 19, -1, -1, -1, -1,
+	-1, 13, -1, -1, 8, 12, -1, -1, 9, 14, -1, -1, -1, -1, -1, -1,
+	-1, -1, 6, -1, 3, -1, 5, -1, 4, -1, 7, -1, -1, -1, -1, -1,
+	1, -1, -1, -1, 0, -1, -1, -1, 2, -1, -1, -1, -1, -1, -1, -1
+};
+static const char ORIENTS_BY_FACES[NFACES][NFACES] = {
+	{-1, 0, 1, 3, 2, -1},
+	{4, -1, 7, 5, -1, 6},
+	{8, 9, -1, -1, 11, 10},
+	{12, 15, -1, -1, 13, 14},
+	{16, -1, 17, 19, -1, 18},
+	{-1, 20, 23, 21, 22, -1}
+};
+static const char POSITIONS_BY_ORIENT[NMINICUBES][NORIENTS] = {
+	{0, 5, 7, 2, 2, 0, 5, 7, 14, 12, 17, 19, 0, 5, 7, 2, 12, 17, 19, 14, 14, 12, 17, 19},
+	{1, 3, 6, 4, 1, 3, 6, 4, 9, 8, 10, 11, 8, 10, 11, 9, 13, 15, 18, 16, 13, 15, 18, 16},
+	{2, 0, 5, 7, 0, 5, 7, 2, 2, 0, 5, 7, 12, 17, 19, 14, 14, 12, 17, 19, 12, 17, 19, 14},
+	{3, 6, 4, 1, 9, 8, 10, 11, 13, 15, 18, 16, 1, 3, 6, 4, 8, 10, 11, 9, 16, 13, 15, 18},
+	{4, 1, 3, 6, 8, 10, 11, 9, 1, 3, 6, 4, 13, 15, 18, 16, 9, 8, 10, 11, 15, 18, 16, 13},
+	{5, 7, 2, 0, 14, 12, 17, 19, 12, 17, 19, 14, 2, 0, 5, 7, 0, 5, 7, 2, 19, 14, 12, 17},
+	{6, 4, 1, 3, 13, 15, 18, 16, 8, 10, 11, 9, 9, 8, 10, 11, 1, 3, 6, 4, 18, 16, 13, 15},
+	{7, 2, 0, 5, 12, 17, 19, 14, 0, 5, 7, 2, 14, 12, 17, 19, 2, 0, 5, 7, 17, 19, 14, 12},
+	{8, 10, 11, 9, 4, 1, 3, 6, 16, 13, 15, 18, 3, 6, 4, 1, 15, 18, 16, 13, 9, 8, 10, 11},
+	{9, 8, 10, 11, 3, 6, 4, 1, 4, 1, 3, 6, 15, 18, 16, 13, 16, 13, 15, 18, 8, 10, 11, 9},
+	{10, 11, 9, 8, 16, 13, 15, 18, 15, 18, 16, 13, 4, 1, 3, 6, 3, 6, 4, 1, 11, 9, 8, 10},
+	{11, 9, 8, 10, 15, 18, 16, 13, 3, 6, 4, 1, 16, 13, 15, 18, 4, 1, 3, 6, 10, 11, 9, 8},
+	{12, 17, 19, 14, 7, 2, 0, 5, 19, 14, 12, 17, 5, 7, 2, 0, 17, 19, 14, 12, 2, 0, 5, 7},
+	{13, 15, 18, 16, 6, 4, 1, 3, 11, 9, 8, 10, 10, 11, 9, 8, 18, 16, 13, 15, 1, 3, 6, 4},
+	{14, 12, 17, 19, 5, 7, 2, 0, 7, 2, 0, 5, 17, 19, 14, 12, 19, 14, 12, 17, 0, 5, 7, 2},
+	{15, 18, 16, 13, 11, 9, 8, 10, 18, 16, 13, 15, 6, 4, 1, 3, 10, 11, 9, 8, 4, 1, 3, 6},
+	{16, 13, 15, 18, 10, 11, 9, 8, 6, 4, 1, 3, 18, 16, 13, 15, 11, 9, 8, 10, 3, 6, 4, 1},
+	{17, 19, 14, 12, 19, 14, 12, 17, 17, 19, 14, 12, 7, 2, 0, 5, 5, 7, 2, 0, 7, 2, 0, 5},
+	{18, 16, 13, 15, 18, 16, 13, 15, 10, 11, 9, 8, 11, 9, 8, 10, 6, 4, 1, 3, 6, 4, 1, 3},
+	{19, 14, 12, 17, 17, 19, 14, 12, 5, 7, 2, 0, 19, 14, 12, 17, 7, 2, 0, 5, 5, 7, 2, 0}
+};
+static const char FACELET_POSITIONS[NFACELETS] = {
+	12, 13, 14, 15, -1, 16, 17, 18, 19, 19, 16, 14, 11, -1, 9, 7,
+	4, 2, 17, 18, 19, 10, -1, 11, 5, 6, 7, 5, 6, 7, 3, -1,
+	4, 0, 1, 2, 12, 15, 17, 8, -1, 10, 0, 3, 5, 14, 13, 12,
+	9, -1, 8, 2, 1, 0
+};
+static const char FACELET_FACES[NFACELETS] = {
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 3, 3, 3, 3, 3, 3,
+	3, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 5, 5, 5, 5, 5,
+	5, 5, 5, 5, 2, 2, 2, 2, 2, 2, 2, 2, 2, 4, 4, 4,
+	4, 4, 4, 4, 4, 4
+};
+static const char POSITION_FACELETS[NMINICUBES][NFACES] = {
+	{-1, -1, 42, -1, 53, 33},
+	{-1, -1, -1, -1, 52, 34},
+	{-1, -1, -1, 17, 51, 35},
+	{-1, -1, 43, -1, -1, 30},
+	{-1, -1, -1, 16, -1, 32},
+	{-1, 24, 44, -1, -1, 27},
+	{-1, 25, -1, -1, -1, 28},
+	{-1, 26, -1, 15, -1, 29},
+	{-1, -1, 39, -1, 50, -1},
+	{-1, -1, -1, 14, 48, -1},
+	{-1, 21, 41, -1, -1, -1},
+	{-1, 23, -1, 12, -1, -1},
+	{0, -1, 36, -1, 47, -1},
+	{1, -1, -1, -1, 46, -1},
+	{2, -1, -1, 11, 45, -1},
+	{3, -1, 37, -1, -1, -1},
+	{5, -1, -1, 10, -1, -1},
+	{6, 18, 38, -1, -1, -1},
+	{7, 19, -1, -1, -1, -1},
+	{8, 20, -1, 9, -1, -1}
+};
+static const char FACELET_ORIENTS[NMINICUBES][NFACES][NFACES] = {
+	{
+		{-1, 11, 19, 7, 15, -1},
+		{14, -1, 3, 23, -1, 8},
+		{6, 22, -1, -1, 0, 16},
+		{18, 2, -1, -1, 20, 4},
+		{10, -1, 21, 1, -1, 12},
+		{-1, 13, 5, 17, 9, -1}
+	},
+	{
+		{-1, 18, 14, 10, 6, -1},
+		{22, -1, 13, 11, -1, 2},
+		{21, 19, -1, -1, 5, 3},
+		{23, 17, -1, -1, 7, 1},
+		{20, -1, 15, 9, -1, 0},
+		{-1, 16, 12, 8, 4, -1}
+	},
+	{
+		{-1, 13, 5, 17, 9, -1},
+		{10, -1, 21, 1, -1, 12},
+		{18, 2, -1, -1, 20, 4},
+		{6, 22, -1, -1, 0, 16},
+		{14, -1, 3, 23, -1, 8},
+		{-1, 11, 19, 7, 15, -1}
+	},
+	{
+		{-1, 19, 15, 11, 7, -1},
+		{23, -1, 14, 8, -1, 3},
+		{22, 16, -1, -1, 6, 0},
+		{20, 18, -1, -1, 4, 2},
+		{21, -1, 12, 10, -1, 1},
+		{-1, 17, 13, 9, 5, -1}
+	},
+	{
+		{-1, 17, 13, 9, 5, -1},
+		{21, -1, 12, 10, -1, 1},
+		{20, 18, -1, -1, 4, 2},
+		{22, 16, -1, -1, 6, 0},
+		{23, -1, 14, 8, -1, 3},
+		{-1, 19, 15, 11, 7, -1}
+	},
+	{
+		{-1, 8, 16, 4, 12, -1},
+		{15, -1, 0, 20, -1, 9},
+		{7, 23, -1, -1, 1, 17},
+		{19, 3, -1, -1, 21, 5},
+		{11, -1, 22, 2, -1, 13},
+		{-1, 14, 6, 18, 10, -1}
+	},
+	{
+		{-1, 16, 12, 8, 4, -1},
+		{20, -1, 15, 9, -1, 0},
+		{23, 17, -1, -1, 7, 1},
+		{21, 19, -1, -1, 5, 3},
+		{22, -1, 13, 11, -1, 2},
+		{-1, 18, 14, 10, 6, -1}
+	},
+	{
+		{-1, 12, 4, 16, 8, -1},
+		{9, -1, 20, 0, -1, 15},
+		{17, 1, -1, -1, 23, 7},
+		{5, 21, -1, -1, 3, 19},
+		{13, -1, 2, 22, -1, 11},
+		{-1, 10, 18, 6, 14, -1}
+	},
+	{
+		{-1, 11, 19, 7, 15, -1},
+		{14, -1, 3, 23, -1, 8},
+		{6, 22, -1, -1, 0, 16},
+		{18, 2, -1, -1, 20, 4},
+		{10, -1, 21, 1, -1, 12},
+		{-1, 13, 5, 17, 9, -1}
+	},
+	{
+		{-1, 13, 5, 17, 9, -1},
+		{10, -1, 21, 1, -1, 12},
+		{18, 2, -1, -1, 20, 4},
+		{6, 22, -1, -1, 0, 16},
+		{14, -1, 3, 23, -1, 8},
+		{-1, 11, 19, 7, 15, -1}
+	},
+	{
+		{-1, 8, 16, 4, 12, -1},
+		{15, -1, 0, 20, -1, 9},
+		{7, 23, -1, -1, 1, 17},
+		{19, 3, -1, -1, 21, 5},
+		{11, -1, 22, 2, -1, 13},
+		{-1, 14, 6, 18, 10, -1}
+	},
+	{
+		{-1, 12, 4, 16, 8, -1},
+		{9, -1, 20, 0, -1, 15},
+		{17, 1, -1, -1, 23, 7},
+		{5, 21, -1, -1, 3, 19},
+		{13, -1, 2, 22, -1, 11},
+		{-1, 10, 18, 6, 14, -1}
+	},
+	{
+		{-1, 3, 0, 2, 1, -1},
+		{7, -1, 6, 4, -1, 5},
+		{11, 8, -1, -1, 10, 9},
+		{15, 14, -1, -1, 12, 13},
+		{19, -1, 16, 18, -1, 17},
+		{-1, 23, 22, 20, 21, -1}
+	},
+	{
+		{-1, 2, 3, 1, 0, -1},
+		{6, -1, 5, 7, -1, 4},
+		{10, 11, -1, -1, 9, 8},
+		{14, 13, -1, -1, 15, 12},
+		{18, -1, 19, 17, -1, 16},
+		{-1, 22, 21, 23, 20, -1}
+	},
+	{
+		{-1, 1, 2, 0, 3, -1},
+		{5, -1, 4, 6, -1, 7},
+		{9, 10, -1, -1, 8, 11},
+		{13, 12, -1, -1, 14, 15},
+		{17, -1, 18, 16, -1, 19},
+		{-1, 21, 20, 22, 23, -1}
+	},
+	{
+		{-1, 3, 0, 2, 1, -1},
+		{7, -1, 6, 4, -1, 5},
+		{11, 8, -1, -1, 10, 9},
+		{15, 14, -1, -1, 12, 13},
+		{19, -1, 16, 18, -1, 17},
+		{-1, 23, 22, 20, 21, -1}
+	},
+	{
+		{-1, 1, 2, 0, 3, -1},
+		{5, -1, 4, 6, -1, 7},
+		{9, 10, -1, -1, 8, 11},
+		{13, 12, -1, -1, 14, 15},
+		{17, -1, 18, 16, -1, 19},
+		{-1, 21, 20, 22, 23, -1}
+	},
+	{
+		{-1, 0, 1, 3, 2, -1},
+		{4, -1, 7, 5, -1, 6},
+		{8, 9, -1, -1, 11, 10},
+		{12, 15, -1, -1, 13, 14},
+		{16, -1, 17, 19, -1, 18},
+		{-1, 20, 23, 21, 22, -1}
+	},
+	{
+		{-1, 0, 1, 3, 2, -1},
+		{4, -1, 7, 5, -1, 6},
+		{8, 9, -1, -1, 11, 10},
+		{12, 15, -1, -1, 13, 14},
+		{16, -1, 17, 19, -1, 18},
+		{-1, 20, 23, 21, 22, -1}
+	},
+	{
+		{-1, 0, 1, 3, 2, -1},
+		{4, -1, 7, 5, -1, 6},
+		{8, 9, -1, -1, 11, 10},
+		{12, 15, -1, -1, 13, 14},
+		{16, -1, 17, 19, -1, 18},
+		{-1, 20, 23, 21, 22, -1}
+	}
+};
+static const char STICKER_INDEXES[NMINICUBES][NFACES] = {
+	{-1, -1, 0, -1, 1, 2},
+	{-1, -1, -1, -1, 3, 4},
+	{-1, -1, -1, 5, 6, 7},
+	{-1, -1, 8, -1, -1, 9},
+	{-1, -1, -1, 10, -1, 11},
+	{-1, 12, 13, -1, -1, 14},
+	{-1, 15, -1, -1, -1, 16},
+	{-1, 17, -1, 18, -1, 19},
+	{-1, -1, 20, -1, 21, -1},
+	{-1, -1, -1, 22, 23, -1},
+	{-1, 24, 25, -1, -1, -1},
+	{-1, 26, -1, 27, -1, -1},
+	{28, -1, 29, -1, 30, -1},
+	{31, -1, -1, -1, 32, -1},
+	{33, -1, -1, 34, 35, -1},
+	{36, -1, 37, -1, -1, -1},
+	{38, -1, -1, 39, -1, -1},
+	{40, 41, 42, -1, -1, -1},
+	{43, 44, -1, -1, -1, -1},
+	{45, 46, -1, 47, -1, -1}
+};